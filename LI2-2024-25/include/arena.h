@@ -0,0 +1,75 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define TAMANHO_BLOCO_ARENA (64 * 1024)     // Bytes de cada bloco pedido ao sistema (reservas maiores têm bloco próprio)
+
+// Bloco de memória da arena; os dados vêm logo a seguir ao cabeçalho
+typedef struct BlocoArena {
+    struct BlocoArena *anterior;    // Bloco usado antes deste, ou o seguinte na lista de livres
+    size_t tamanho;                 // Bytes de dados
+    size_t usado;
+} BlocoArena;
+
+typedef struct {
+    long reservas;          // Reservas feitas
+    long blocos;            // Blocos pedidos ao sistema
+    long reutilizacoes;     // Blocos reaproveitados da lista de livres
+    long devolvidos;        // Objetos devolvidos a um slab e reaproveitados
+    size_t emUso;           // Bytes reservados e ainda não devolvidos
+    size_t pico;            // Máximo de emUso
+    size_t total;           // Bytes de todos os blocos, em uso ou livres
+} EstatisticasArena;
+
+// Arena: reservas por incremento de um ponteiro, devolvidas de uma vez ao voltar a uma marca.
+// Os blocos libertados ficam numa lista de livres, pelo que um padrão de uso repetido (uma
+// resolução, uma ajuda) deixa de pedir memória ao sistema depois da primeira vez.
+typedef struct {
+    BlocoArena *atual;
+    BlocoArena *livres;
+    size_t tamanhoBloco;
+    EstatisticasArena estatisticas;
+} Arena;
+
+// Estado da arena num dado momento; voltar a ela devolve tudo o que foi reservado depois.
+// As marcas têm de ser usadas pela ordem inversa à da criação.
+typedef struct {
+    BlocoArena *bloco;
+    size_t usado;
+    size_t emUso;
+} MarcaArena;
+
+// Slab: objetos do mesmo tamanho tirados de uma arena própria, com uma lista de devolvidos
+typedef struct {
+    Arena arena;
+    size_t tamanho;
+    void *livres;
+} Slab;
+
+void iniciarArena(Arena *arena, size_t tamanhoBloco);
+
+void libertarArena(Arena *arena);
+
+Arena* criarArena(size_t tamanhoBloco);
+
+void freeArena(Arena *arena);
+
+void* reservarArena(Arena *arena, size_t bytes);
+
+void* reservarArenaZerada(Arena *arena, size_t bytes);
+
+MarcaArena marcarArena(Arena *arena);
+
+void voltarArena(Arena *arena, MarcaArena marca);
+
+void iniciarSlab(Slab *slab, size_t tamanho, size_t tamanhoBloco);
+
+void libertarSlab(Slab *slab);
+
+void* reservarSlab(Slab *slab);
+
+void devolverSlab(Slab *slab, void *objeto);
+
+
+#endif
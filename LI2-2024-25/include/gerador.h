@@ -0,0 +1,32 @@
+#ifndef GERADOR_H
+#define GERADOR_H
+
+#include <stdint.h>
+#include "../include/jogo.h"
+
+// Geração de tabuleiros com solução única (jogo --generate)
+
+#define SAIDA_GERADOR_PADRAO "gerados"
+
+// Uma linha com mais de NUM_LETRAS casas precisa de riscadas para as brancas terem letras
+// diferentes: a partir de 35 casas são mais de um quarto da linha, em todas as linhas e colunas,
+// e o gerador deixa de encontrar padrões. A partir de 40 seria preciso mais de um terço, o que
+// nenhum tabuleiro com as brancas ligadas e sem riscadas adjacentes consegue.
+#define MAX_DIMENSAO_GERADOR 34
+
+typedef struct {
+    int linhas;
+    int colunas;
+    int densidade;          // Probabilidade (%) de tentar riscar cada casa ao gerar o padrão
+    uint64_t semente;
+} ParametrosGerador;
+
+// Gera um jogo por resolver cuja única solução é provada pelo resolvedor; NULL se falhar
+Jogo* gerarJogoUnico(const ParametrosGerador *parametros, uint64_t *estado);
+
+int gravarTabuleiroGerado(Jogo *jogo, const char *arquivo);
+
+// Gera quantidade tabuleiros na pasta, repartidos por numThreads threads
+int gerarLoteTabuleiros(const char *pasta, int quantidade, const ParametrosGerador *parametros, int numThreads);
+
+#endif
@@ -1,28 +1,163 @@
 #ifndef JOGO_H
 #define JOGO_H
 
-typedef struct Movimento {
-    int linha;
-    int coluna;
+#include <stdio.h>
+#include <stdint.h>
+#include "../include/arena.h"
+
+// Dimensão máxima suportada: cada linha/coluna cabe numa máscara de 64 bits
+#define MAX_DIMENSAO 64
+#define NUM_LETRAS 26
+
+typedef uint64_t Mascara;
+
+// Marca de grupo de um movimento: os movimentos de um grupo (comando 'A') são desfeitos juntos
+typedef enum {
+    MOVIMENTO_SIMPLES,
+    MOVIMENTO_INICIO_GRUPO,     // Primeiro movimento de um grupo
+    MOVIMENTO_GRUPO             // Restantes movimentos do grupo
+} TipoMovimento;
+
+// Estado de uma casa em 2 bits; a letra vem do tabuleiro inicial
+typedef enum {
+    CASA_POR_DECIDIR,
+    CASA_BRANCA,
+    CASA_RISCADA
+} EstadoCasa;
+
+// Entrada do histórico: 4 bytes (as coordenadas cabem num byte, porque MAX_DIMENSAO é 64)
+typedef struct {
+    uint8_t linha;
+    uint8_t coluna;
     char estadoAnterior;
-    struct Movimento *proximo;
-    struct Movimento *grupoInterno; // Para armazenar movimentos agrupados
+    unsigned int grupo : 2;             // TipoMovimento
+    unsigned int estadoPosterior : 2;   // EstadoCasa da casa depois do movimento
 } Movimento;
 
+#define INTERVALO_PONTOS 256    // Movimentos entre dois pontos de restauro do histórico
+
+// Histórico guardado num vetor que cresce, do movimento mais antigo para o mais recente.
+// Os movimentos desfeitos ficam no vetor até ser registado um movimento novo, para poderem ser refeitos.
+// O ponto de restauro p guarda o estado (2 bits) de cada casa depois de p * INTERVALO_PONTOS movimentos,
+// pelo que qualquer estado do histórico fica a no máximo INTERVALO_PONTOS movimentos de um ponto.
+typedef struct {
+    Movimento *movimentos;
+    int numMovimentos;
+    int capacidade;
+    int inicioGrupo;            // Índice onde começa o grupo em curso, ou -1 fora de um agrupamento
+    int fim;                    // [numMovimentos, fim): movimentos desfeitos que podem ser refeitos
+    uint8_t *pontos;            // numPontos pontos de restauro seguidos, de (casas + 3) / 4 bytes cada
+    int numPontos;
+    int capacidadePontos;
+} HistoricoMovimentos;
+
+// Máscaras de bits por linha (bit j) e por coluna (bit i), mantidas em sincronia com o tabuleiro
+typedef struct {
+    Mascara *brancasLinha;
+    Mascara *riscadasLinha;
+    Mascara *indecisasLinha;
+    Mascara *brancasColuna;
+    Mascara *riscadasColuna;
+    Mascara *indecisasColuna;
+    Mascara *letraLinha;        // [letra * linhas + i]: ocorrências (não riscadas) da letra na linha i
+    Mascara *letraColuna;       // [letra * colunas + j]: ocorrências (não riscadas) da letra na coluna j
+    // Contadores mantidos com as máscaras, para saber em O(1) se o tabuleiro está resolvido
+    int indecisas;              // Casas por decidir
+    int *excessoLinha;          // Ocorrências (não riscadas) a mais de letras repetidas na linha i
+    int *excessoColuna;         // O mesmo para a coluna j
+    int excessoLetras;          // Soma dos excessos de todas as linhas e colunas
+    int paresRiscados;          // Pares de casas riscadas ortogonalmente adjacentes
+    // Conjunto de violações em cache, refeito só à volta de cada casa alterada
+    int paresRiscadaIndecisa;   // Pares (riscada, vizinha por decidir)
+    Mascara linhasDuplicadas;   // Bit i: a linha i tem letras repetidas
+    Mascara colunasDuplicadas;  // Bit j: a coluna j tem letras repetidas
+    Mascara *violacoesLinha;    // Bit j: a riscada (i, j) tem uma vizinha por decidir ou uma riscada à direita/abaixo
+    uint64_t hash;              // Hash de Zobrist do tabuleiro: XOR das chaves (casa, valor) de todas as casas
+} MascarasTabuleiro;
+
+// Union-find das casas riscadas (ligadas também na diagonal) com um nó extra para a borda.
+// As brancas ficam separadas exatamente quando as riscadas fecham um ciclo ou ligam duas
+// partes da borda. Sem compressão de caminhos, para que cada riscada possa ser desfeita.
+typedef struct {
+    int *pai;               // pai[k], ou -1 se a casa k não está riscada; pai[borda] = borda
+    int *tamanho;
+    int *unioes;            // Pilha das raízes ligadas a outra raiz, para desfazer
+    int numUnioes;
+    int *riscadas;          // Pilha de (casa, numUnioes antes, variação de componentes)
+    int numRiscadas;
+    int componentes;        // Número de regiões de casas não riscadas
+    int invalida;           // Foi retirada uma riscada fora de ordem: reconstruir na próxima consulta
+} UniaoRiscadas;
+
+// Memória de trabalho reutilizável para as travessias do tabuleiro, criada no primeiro uso.
+// Uma casa k está marcada na travessia atual quando marca[k] == epoca, o que evita limpar o vetor.
+typedef struct {
+    unsigned int *marca;
+    unsigned int epoca;
+    int *pilha;
+    int *descoberta;
+    int *baixo;
+    int *pai;
+    char *direcao;
+    char *articulacao;
+    long chamadasConectividade; // Número de verificações de conectividade feitas
+} AreaTrabalho;
+
+// O tabuleiro é guardado num único vetor com uma moldura de sentinelas '\0' à volta:
+// a casa (i, j) fica em celulas[(i + 1) * largura + j], com largura = colunas + 1.
+// A sentinela no fim de cada linha é também a vizinha esquerda da linha seguinte e termina
+// a linha como string, pelo que tabuleiro[i] continua a ser uma vista válida da linha i.
+#define INDICE_CELULA(jogo, linha, coluna) (((linha) + 1) * (jogo)->largura + (coluna))
+
 typedef struct{
-    char **tabuleiro;
+    char **tabuleiro;           // Vista por linhas sobre 'celulas'
+    char *celulas;
+    char *inicial;              // Vetor do tabuleiro antes de todos os movimentos do histórico
+    int largura;
+    int deslocamentos[4];       // Vizinhas ortogonais no vetor: cima, baixo, esquerda, direita
     int linhas;
     int colunas;
-    Movimento *historicoMovimentos;
+    HistoricoMovimentos historico;
     int modoAjudaAtiva;
-    int agrupandoMovimentos;    // Nova flag para indicar agrupamento
-    Movimento *grupoMovimentos; // Nova lista para movimentos temporários
+    MascarasTabuleiro *mascaras;
+    UniaoRiscadas *uniao;
+    AreaTrabalho *trabalho;
+    Arena *arena;               // Memória temporária do resolvedor e da ajuda, criada no primeiro uso
 } Jogo;
 
 
+// Resultado da validação do tabuleiro, sem qualquer escrita no terminal
+typedef enum {
+    VIOLACAO_DUPLICADOS_LINHA,      // linha
+    VIOLACAO_DUPLICADOS_COLUNA,     // coluna
+    VIOLACAO_VIZINHO_NAO_BRANCO,    // casa vizinha de uma riscada
+    VIOLACAO_RISCADAS_ADJACENTES,   // riscada com outra à direita ou abaixo (conta cada par)
+    VIOLACAO_BRANCAS_DESCONEXAS,    // sem coordenadas
+    NUM_TIPOS_VIOLACAO
+} TipoViolacao;
+
+typedef struct {
+    TipoViolacao tipo;
+    int linha;      // -1 quando não se aplica
+    int coluna;     // -1 quando não se aplica
+} Violacao;
+
+typedef struct {
+    int total;
+    int porTipo[NUM_TIPOS_VIOLACAO];
+    Violacao *lista;    // Opcional (NULL: só contagens)
+    int capacidade;
+    int numListadas;
+} ResultadoValidacao;
+
+// Limite de violações listadas num tabuleiro: linhas, colunas, 4 vizinhos e 1 adjacência por casa, e a conectividade
+#define MAX_VIOLACOES(jogo) ((jogo)->linhas + (jogo)->colunas + 5 * (jogo)->linhas * (jogo)->colunas + 1)
+
 // Funções etapa 1
 Jogo* carregarJogo (char *arquivo);
 
+Jogo* criarJogo(int linhas, int colunas, const char *casas);
+
 void carregarHistoricoMovimentos(FILE *input, Jogo *jogo);
 
 int gravarJogo(Jogo *jogo, char *arquivo);
@@ -35,15 +170,55 @@ int riscar (Jogo *jogo, char *coordenada);
 
 void freeJogo(Jogo *jogo);
 
+int reporTabuleiroInicial(Jogo *jogo);
+
+// Máscaras de bits do tabuleiro
+
+MascarasTabuleiro* criarMascaras(Jogo *jogo);
+
+void freeMascaras(MascarasTabuleiro *mascaras);
+
+void alterarCelula(Jogo *jogo, int linha, int coluna, char novo);
+
+int existeOutraBrancaNaLinha(Jogo *jogo, int linha, int coluna, char letra);
+
+int existeOutraBrancaNaColuna(Jogo *jogo, int linha, int coluna, char letra);
+
+// Conectividade incremental das casas riscadas
+
+UniaoRiscadas* criarUniaoRiscadas(Jogo *jogo);
+
+void freeUniaoRiscadas(UniaoRiscadas *uniao);
+
+int riscarSepararia(Jogo *jogo, int linha, int coluna);
+
+int regiaoNaoRiscadaConexa(Jogo *jogo);
+
 // Funções etapa 2
 
-void registarMovimento(Jogo *jogo, int linha, int coluna, char estadoAnterior);
+int registarMovimento(Jogo *jogo, int linha, int coluna, char estadoAnterior);
+
+int aplicarMovimento(Jogo *jogo, int linha, int coluna, char novo);
 
 int desfazerMovimento(Jogo *jogo);
 
+int validarTabuleiro(Jogo *jogo, ResultadoValidacao *resultado);
+
+int validarTabuleiroCompleto(Jogo *jogo, ResultadoValidacao *resultado);
+
 int verificarRestricoes(Jogo *jogo);
 
-void freeHistoricoMovimentos(Movimento *historico);
+int numeroMovimentos(Jogo *jogo);
+
+Movimento* ultimoMovimento(Jogo *jogo);
+
+int copiarHistoricoMovimentos(HistoricoMovimentos *destino, const HistoricoMovimentos *origem);
+
+int irParaMovimento(Jogo *jogo, int movimento);
+
+int refazerMovimento(Jogo *jogo);
+
+void freeHistoricoMovimentos(HistoricoMovimentos *historico);
 
 // Funções etapa 3
 
@@ -51,6 +226,14 @@ void dfs(Jogo *jogo, int **visitado, int *visitadas, int linha, int coluna);
 
 int verificarConectividadeBrancas(Jogo *jogo);
 
+int calcularPontosArticulacao(Jogo *jogo, char *articulacao);
+
+AreaTrabalho* obterAreaTrabalho(Jogo *jogo);
+
+void freeAreaTrabalho(AreaTrabalho *trabalho);
+
+Arena* obterArena(Jogo *jogo);
+
 // Funções etapa 4
 
 void iniciarAgrupamentoMovimentos(Jogo *jogo);
@@ -59,6 +242,8 @@ void finalizarAgrupamentoMovimentos(Jogo *jogo);
 
 int ajudar(Jogo *jogo);
 
+int ajudaAutomatica(Jogo *jogo, int *rondas, long *disparos);
+
 int backtrackingResolver(Jogo *jogo);
 
 Jogo* copiarJogo(Jogo* original);
@@ -67,8 +252,15 @@ void restaurarJogo(Jogo* destino, Jogo* origem);
 
 int resolverJogo(Jogo *jogo);
 
+int resolverJogoComThreads(Jogo *jogo, int numThreads);
+
+int contarSolucoesJogo(Jogo *jogo, int limite);
+
 int verificarVitoria(Jogo *jogo);
 
+// Lista de comandos do menu inicial e da ajuda
+void exibirComandos(void);
+
 // Função principal
 int processarComandos(Jogo **jogo, char *comando);
 
@@ -0,0 +1,25 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+// Resolução não interativa de muitos tabuleiros (jogo --solve-batch)
+
+#define SAIDA_LOTE_PADRAO "solucoes"
+
+typedef struct {
+    int resolvidos;
+    int semSolucao;
+    int erros;
+} ResultadoLote;
+
+// Lista os tabuleiros de uma pasta (por ordem de nome) ou de um ficheiro com um caminho por linha.
+// Em erro devolve NULL com *numFicheiros a -1; uma pasta ou lista vazia dá NULL com 0.
+char** listarTabuleiros(const char *entrada, int *numFicheiros);
+
+void freeListaTabuleiros(char **ficheiros, int numFicheiros);
+
+// Resolve cada tabuleiro a partir do seu estado inicial (os movimentos gravados no ficheiro são
+// ignorados) e escreve a solução (ou "unsolvable") na pasta de saída, com o nome do tabuleiro.
+// Tabuleiros com o mesmo nome são recusados antes de resolver qualquer um.
+int resolverLote(const char *entrada, const char *pastaSaida, int numThreads, ResultadoLote *resultado);
+
+#endif
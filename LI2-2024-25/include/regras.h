@@ -0,0 +1,33 @@
+#ifndef REGRAS_H
+#define REGRAS_H
+
+#include "../include/jogo.h"
+
+// Regras de dedução extra, tentadas quando as três regras base já não decidem nada
+
+typedef enum {
+    REGRA_SANDUICHE,        // x?x numa linha ou coluna: a casa do meio é branca
+    REGRA_PAR_ADJACENTE,    // xx numa linha ou coluna: as outras ocorrências de x ficam riscadas
+    REGRA_CANTO,            // padrões de 2x2 num canto que isolariam a casa do canto
+    REGRA_LETRA_UNICA,      // letra sem repetição na linha e na coluna: branca
+    NUM_REGRAS
+} IdRegra;
+
+// Chamada para cada casa deduzida; a regra que a deduziu vem em 'regra'
+typedef void (*DecidirCasa)(Jogo *jogo, int linha, int coluna, char novo, IdRegra regra, void *contexto);
+
+typedef struct {
+    const char *nome;
+    const char *descricao;      // Justificação mostrada pela ajuda
+    int (*aplicar)(Jogo *jogo, IdRegra regra, DecidirCasa decidir, void *contexto);
+    int exigeSolucaoUnica;      // Pode afastar soluções alternativas: não serve para as contar
+    int soLetras;               // Decorre só das letras e vale em qualquer estado do tabuleiro
+} RegraDeducao;
+
+extern const RegraDeducao REGRAS_DEDUCAO[NUM_REGRAS];
+
+// Tenta as regras por ordem e para na primeira que decide alguma casa; devolve o número de casas
+// decididas. disparos[r], se não for NULL, acumula as casas decididas por cada regra.
+int aplicarRegrasDeducao(Jogo *jogo, int incluirSolucaoUnica, DecidirCasa decidir, void *contexto, long *disparos);
+
+#endif
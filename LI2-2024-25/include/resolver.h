@@ -0,0 +1,143 @@
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include "../include/jogo.h"
+#include "../include/regras.h"
+
+#define MAX_THREADS 64
+#define ORCAMENTO_SONDAGEM_PADRAO 2000
+
+// Limites da base de nogoods aprendidos pela procura
+#define MAX_NOGOODS 4096
+#define MAX_LITERAIS_NOGOOD 32          // Nogoods maiores não são guardados
+#define MEMORIA_NOGOODS (256 * 1024)    // Bytes reservados para os literais
+
+#define MEMORIA_TRANSPOSICAO_PADRAO (1024 * 1024)  // Bytes da tabela de transposição de cada procura
+
+typedef struct {
+    long nos;           // Nós da árvore de procura visitados
+    long retrocessos;   // Ramos abandonados por contradição
+    long deducoes;      // Casas decididas por propagação
+    long disparosRegras[NUM_REGRAS]; // Casas decididas por cada regra da tabela (incluídas em deducoes)
+    long sondagens;     // Valores experimentados pela sondagem
+    long nogoods;       // Nogoods aprendidos com os conflitos
+    long usosNogoods;   // Casas decididas ou contradições detetadas pelos nogoods
+    long saltos;        // Retrocessos que saltaram níveis sem conflito
+    long memoriaNogoods; // Bytes ocupados pelos nogoods
+    long acertosTransposicao; // Tabuleiros encontrados na tabela de transposição
+    long falhasTransposicao;  // Consultas à tabela sem resultado
+    long memoriaTarefas;      // Bytes pedidos ao sistema para os tabuleiros das tarefas da procura paralela
+} EstatisticasResolver;
+
+// Escolha da casa onde a procura ramifica e da ordem dos valores
+typedef enum {
+    HEURISTICA_PRIMEIRA,    // Primeira casa por decidir, branco antes de riscado
+    HEURISTICA_CONFLITOS,   // Casa com mais repetições da letra (ou junto a riscadas), valor pelo mesmo critério
+    NUM_HEURISTICAS
+} Heuristica;
+
+extern const char *NOMES_HEURISTICAS[NUM_HEURISTICAS];
+
+// Rasto das casas alteradas pela procura, com marcas por nível de decisão.
+// O rasto e a aprendizagem vivem na arena do jogo e têm de ser libertados pela ordem inversa à da criação.
+typedef struct {
+    int *posicoes;      // Posição da casa no vetor do tabuleiro
+    char *anteriores;   // Valor da casa antes da alteração
+    int topo;
+    int *niveis;        // Topo do rasto no início de cada nível
+    int nivel;
+    int capacidade;
+    Arena *arena;       // Arena do jogo de onde veio a memória
+    MarcaArena marca;   // Estado da arena antes da criação, reposto por freeRasto
+} Rasto;
+
+// Aprendizagem da procura: a razão de cada casa decidida é o conjunto dos níveis de decisão (bit n:
+// nível n) de que o seu valor depende. Um conflito junta as razões das casas envolvidas; as decisões
+// desses níveis formam um nogood, e a procura volta logo ao nível mais alto do conflito.
+typedef struct {
+    int palavras;           // Palavras de 64 bits de cada conjunto de níveis
+    int nivel;              // Nível de decisão atual (0 na raiz)
+    Mascara *razoes;        // [p * palavras]: razão da casa na posição p do vetor do tabuleiro
+    Mascara *conflitos;     // [n * palavras]: conflito que fez falhar o nível n
+    int *decisoes;          // Literal decidido em cada nível: 2 * posição + (1 se riscada)
+    int *literais;          // Literais de todos os nogoods, seguidos
+    int numLiterais;
+    int maxLiterais;
+    int *inicioNogood;      // Nogood g: literais[inicioNogood[g]] a literais[inicioNogood[g + 1] - 1]
+    int numNogoods;
+    long descartados;       // Nogoods não guardados por serem grandes ou por falta de espaço
+    Arena *arena;
+    MarcaArena marca;
+} Aprendizagem;
+
+// Tabela de transposição: hashes de Zobrist de tabuleiros parciais já provados sem solução.
+// Cada entrada é um único hash atómico (0: vazia), por isso as threads da procura paralela
+// partilham a tabela sem trincos. As entradas estão em grupos de 4 e uma nova substitui uma
+// entrada do grupo quando este está cheio.
+typedef struct {
+    _Atomic uint64_t *entradas;
+    size_t mascara;         // Número de entradas - 1 (potência de 2)
+} TabelaTransposicao;
+
+// Rasto de alterações
+Rasto* criarRasto(Jogo *jogo);
+
+void freeRasto(Rasto *rasto);
+
+void abrirNivel(Rasto *rasto);
+
+void voltarAoNivel(Jogo *jogo, Rasto *rasto, int nivel);
+
+// Aprendizagem de nogoods
+Aprendizagem* criarAprendizagem(Jogo *jogo);
+
+void freeAprendizagem(Aprendizagem *aprendizagem);
+
+// Tabela de transposição
+TabelaTransposicao* criarTabelaTransposicao(size_t bytes);
+
+void freeTabelaTransposicao(TabelaTransposicao *tabela);
+
+int consultarTransposicao(TabelaTransposicao *tabela, uint64_t hash);
+
+void guardarTransposicao(TabelaTransposicao *tabela, uint64_t hash);
+
+// Memória máxima da tabela criada por cada procura (0 desativa a tabela)
+void definirMemoriaTransposicao(size_t bytes);
+
+size_t obterMemoriaTransposicao(void);
+
+// Heurística usada pelas procuras seguintes (por omissão HEURISTICA_CONFLITOS)
+void definirHeuristica(Heuristica heuristica);
+
+Heuristica obterHeuristica(void);
+
+int procurarHeuristica(const char *nome);
+
+// Propagação de deduções
+int propagarDeducoes(Jogo *jogo, EstatisticasResolver *estatisticas);
+
+// Sondagem: experimenta os dois valores de cada casa e fixa o oposto de um que falhe
+typedef void (*FixarCasa)(Jogo *jogo, int linha, int coluna, char novo, void *contexto);
+
+void definirOrcamentoSondagem(int orcamento);
+
+int obterOrcamentoSondagem(void);
+
+int sondarCasas(Jogo *jogo, int *orcamento, FixarCasa fixar, void *contexto, EstatisticasResolver *estatisticas);
+
+// Procura com propagação em cada nó
+int procurarSolucao(Jogo *jogo, Rasto *rasto, EstatisticasResolver *estatisticas);
+
+int resolverComPropagacao(Jogo *jogo, EstatisticasResolver *estatisticas);
+
+// Contagem de soluções (até um limite)
+int contarSolucoes(Jogo *jogo, int limite, char **guardar, EstatisticasResolver *estatisticas);
+
+// Procura paralela com roubo de tarefas
+int resolverParalelo(Jogo *jogo, int numThreads, EstatisticasResolver *estatisticas);
+
+
+#endif
@@ -9,6 +9,7 @@ void limpar_arquivo_teste();
 
 // Testes para carregamento de jogo
 void teste_carregar_jogo_valido();
+void teste_carregar_jogo_marca_antiga();
 void teste_carregar_jogo_arquivo_inexistente();
 
 // Testes para pintar e riscar
@@ -17,10 +18,17 @@ void teste_pintar_branco_invalido();
 void teste_riscar_valido();
 void teste_riscar_invalido();
 
+// Testes para o tabuleiro contíguo
+void teste_copiar_jogo_tabuleiro_contiguo();
+
 // Testes para registo e desfazer movimentos
 void teste_registar_movimento();
 void teste_desfazer_movimento();
 void teste_desfazer_movimento_sem_historico();
+void teste_desfazer_grupo_movimentos();
+void teste_refazer_movimentos();
+void teste_ir_para_movimento_com_pontos();
+void teste_ir_para_movimento_depois_de_resolver();
 void teste_desfazer_multiplos_movimentos();
 
 // Testes para verificação de restrições
@@ -34,6 +42,9 @@ void teste_verificar_restricao_vizinhos_riscados_todos();
 void teste_verificar_restricao_vizinhos_riscados_dois_riscados();
 void teste_verificar_restricao_vizinhos_riscados_tres_riscados();
 
+// Testes para as máscaras do tabuleiro
+void teste_mascaras_sincronizadas();
+
 // Testes para conectividade
 void teste_verificar_conectividade_sem_brancas();
 void teste_verificar_conectividade_com_brancas_conectadas();
@@ -41,16 +52,61 @@ void teste_verificar_conectividade_com_brancas_conectadas_com_biforcação();
 void teste_verificar_conectividade_com_brancas_desconectadas();
 void teste_verificar_conectividade_com_brancas_desconectadas_diagonal();
 void teste_verificar_conectividade_com_brancas_desconectadas_e_conectadas();
+void teste_uniao_riscadas_separacao();
+void teste_conectividade_reutiliza_area_trabalho();
 
 
 //Testes para os comandos a, A, R
 void teste_comando_ajuda();
+void teste_ajuda_pontos_articulacao();
+void teste_ajudar_colunas_largas();
 void teste_modo_ajuda_automatica();
+void teste_ajuda_automatica_igual_ajudar();
+void teste_ajuda_automatica_rondas_e_desfazer();
+void teste_regras_sanduiche_e_par();
+void teste_regras_canto_e_letra_unica();
+void teste_sondagem_ajuda_automatica();
+void teste_sondagem_orcamento();
 void teste_resolver_jogo();
 void teste_comando_ajuda_jogo_invalido();
 void teste_resolver_jogo_invalido();
 void teste_interacao_comandos();
 
+// Testes para o resolvedor com propagação
+void teste_resolver_com_propagacao();
+void teste_propagar_deducoes_contradicao();
+void teste_resolver_sem_solucao_preserva_tabuleiro();
+void teste_rasto_volta_ao_nivel();
+void teste_resolver_jogo_regista_movimentos();
+void teste_repor_tabuleiro_inicial();
+void teste_tabuleiro_inicial_de_jogo_gravado();
+void teste_resolver_paralelo_igual_sequencial();
+void teste_resolver_paralelo_sem_solucao();
+void teste_processar_comando_resolver_threads();
+void teste_heuristicas_ramificacao();
+void teste_processar_comando_heuristica();
+void teste_aprendizagem_nogoods();
+void teste_tabela_transposicao();
+void teste_validar_tabuleiro_estruturado();
+void teste_validar_tabuleiro_so_contagens();
+void teste_contadores_incrementais();
+void teste_hash_zobrist();
+void teste_arena_marcas();
+void teste_slab_reaproveita();
+void teste_arena_jogo_reaproveitada();
+void teste_vitoria_pelos_contadores();
+void teste_validacao_incremental_igual_completa();
+void teste_validacao_incremental_vizinhanca();
+void teste_contar_solucoes();
+void teste_contar_solucoes_com_nogoods();
+void teste_processar_comando_contar();
+void teste_gerar_jogo_unico();
+void teste_gerar_jogo_grande();
+void teste_resolver_lote_lista();
+void teste_resolver_lote_ficheiro_invalido();
+void teste_resolver_lote_ignora_movimentos();
+void teste_resolver_lote_nomes_repetidos();
+
 // Testes para comandos
 void teste_processar_comando_carregar();
 void teste_processar_comando_pintar();
@@ -67,6 +123,7 @@ void teste_processar_comando_R();
 // Testes para gravação de jogo
 void teste_gravar_jogo_valido();
 void teste_gravar_jogo_invalido();
+void teste_gravar_historico_com_grupos();
 void teste_processar_comando_gravar();
 
 // Inicialização da suíte
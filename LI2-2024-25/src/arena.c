@@ -0,0 +1,159 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "../include/arena.h"
+
+// Todas as reservas ficam alinhadas como as do malloc
+#define ALINHAMENTO _Alignof(max_align_t)
+#define ALINHAR(bytes) (((bytes) + ALINHAMENTO - 1) & ~(size_t)(ALINHAMENTO - 1))
+#define CABECALHO ALINHAR(sizeof(BlocoArena))
+
+static char* dadosBloco(BlocoArena *bloco) {
+    return (char *)bloco + CABECALHO;
+}
+
+
+// Arena ===============================================================================================
+
+void iniciarArena(Arena *arena, size_t tamanhoBloco) {
+    arena->atual = NULL;
+    arena->livres = NULL;
+    arena->tamanhoBloco = tamanhoBloco > 0 ? tamanhoBloco : TAMANHO_BLOCO_ARENA;
+    arena->estatisticas = (EstatisticasArena){0};
+}
+
+// Liberta todos os blocos de uma vez; a arena fica vazia e pode voltar a ser usada
+void libertarArena(Arena *arena) {
+    BlocoArena *listas[2] = { arena->atual, arena->livres };
+    for (int l = 0; l < 2; l++) {
+        BlocoArena *bloco = listas[l];
+        while (bloco) {
+            BlocoArena *anterior = bloco->anterior;
+            free(bloco);
+            bloco = anterior;
+        }
+    }
+    arena->atual = NULL;
+    arena->livres = NULL;
+    arena->estatisticas.emUso = 0;
+    arena->estatisticas.total = 0;
+}
+
+Arena* criarArena(size_t tamanhoBloco) {
+    Arena *arena = malloc(sizeof(Arena));
+    if (!arena) return NULL;
+    iniciarArena(arena, tamanhoBloco);
+    return arena;
+}
+
+void freeArena(Arena *arena) {
+    if (arena != NULL) {
+        libertarArena(arena);
+        free(arena);
+    }
+}
+
+// Bloco com pelo menos 'bytes' de dados: o menor da lista de livres que chegue, senão um do sistema
+static BlocoArena* obterBloco(Arena *arena, size_t bytes) {
+    BlocoArena **melhor = NULL;
+    for (BlocoArena **livre = &arena->livres; *livre; livre = &(*livre)->anterior) {
+        if ((*livre)->tamanho >= bytes && (!melhor || (*livre)->tamanho < (*melhor)->tamanho)) melhor = livre;
+    }
+    if (melhor) {
+        BlocoArena *bloco = *melhor;
+        *melhor = bloco->anterior;
+        arena->estatisticas.reutilizacoes++;
+        return bloco;
+    }
+
+    size_t tamanho = bytes > arena->tamanhoBloco ? bytes : arena->tamanhoBloco;
+    BlocoArena *bloco = malloc(CABECALHO + tamanho);
+    if (!bloco) return NULL;
+    bloco->tamanho = tamanho;
+    arena->estatisticas.blocos++;
+    arena->estatisticas.total += tamanho;
+    return bloco;
+}
+
+// Devolve memória alinhada para 'bytes' bytes (não inicializada), ou NULL sem memória
+void* reservarArena(Arena *arena, size_t bytes) {
+    if (!arena) return NULL;
+    bytes = ALINHAR(bytes > 0 ? bytes : 1);
+
+    BlocoArena *bloco = arena->atual;
+    if (!bloco || bloco->tamanho - bloco->usado < bytes) {
+        bloco = obterBloco(arena, bytes);
+        if (!bloco) return NULL;
+        bloco->usado = 0;
+        bloco->anterior = arena->atual;
+        arena->atual = bloco;
+    }
+
+    void *memoria = dadosBloco(bloco) + bloco->usado;
+    bloco->usado += bytes;
+
+    EstatisticasArena *e = &arena->estatisticas;
+    e->reservas++;
+    e->emUso += bytes;
+    if (e->emUso > e->pico) e->pico = e->emUso;
+    return memoria;
+}
+
+void* reservarArenaZerada(Arena *arena, size_t bytes) {
+    void *memoria = reservarArena(arena, bytes);
+    if (memoria) memset(memoria, 0, bytes);
+    return memoria;
+}
+
+MarcaArena marcarArena(Arena *arena) {
+    MarcaArena marca = { arena->atual, arena->atual ? arena->atual->usado : 0, arena->estatisticas.emUso };
+    return marca;
+}
+
+// Devolve tudo o que foi reservado depois da marca; os blocos que ficam vazios passam para a
+// lista de livres. Uma marca já ultrapassada por uma volta anterior não tem efeito.
+void voltarArena(Arena *arena, MarcaArena marca) {
+    if (!arena || marca.emUso >= arena->estatisticas.emUso) return;
+
+    while (arena->atual && arena->atual != marca.bloco) {
+        BlocoArena *bloco = arena->atual;
+        arena->atual = bloco->anterior;
+        bloco->anterior = arena->livres;
+        arena->livres = bloco;
+    }
+    if (arena->atual) arena->atual->usado = marca.usado;
+    arena->estatisticas.emUso = marca.emUso;
+}
+
+
+// Slab ================================================================================================
+
+void iniciarSlab(Slab *slab, size_t tamanho, size_t tamanhoBloco) {
+    iniciarArena(&slab->arena, tamanhoBloco);
+    // Um objeto devolvido guarda o ponteiro para o seguinte da lista
+    slab->tamanho = tamanho > sizeof(void *) ? tamanho : sizeof(void *);
+    slab->livres = NULL;
+}
+
+// Liberta de uma vez todos os objetos do slab, devolvidos ou não
+void libertarSlab(Slab *slab) {
+    libertarArena(&slab->arena);
+    slab->livres = NULL;
+}
+
+void* reservarSlab(Slab *slab) {
+    if (slab->livres) {
+        void *objeto = slab->livres;
+        memcpy(&slab->livres, objeto, sizeof(void *));
+        slab->arena.estatisticas.devolvidos++;
+        return objeto;
+    }
+    return reservarArena(&slab->arena, slab->tamanho);
+}
+
+void devolverSlab(Slab *slab, void *objeto) {
+    if (!objeto) return;
+    memcpy(objeto, &slab->livres, sizeof(void *));
+    slab->livres = objeto;
+}
@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../include/jogo.h"
+#include "../include/resolver.h"
+#include "../include/gerador.h"
+
+// Medição de desempenho: gera um corpo de tabuleiros de 5x5 a 34x34, junta-lhe os tabuleiros do
+// repositório e mede as operações principais. O relatório sai em CSV no stdout; tudo o que as
+// funções do jogo escrevem no terminal é desviado para /dev/null.
+
+#define PASTA_CORPUS_PADRAO "bench_corpus"
+#define REPETICOES_PADRAO 15
+#define MAX_CAMINHO 512
+
+// Até MAX_DIMENSAO_GERADOR: acima disso as linhas não têm letras para um tabuleiro com solução
+static const int DIMENSOES_CORPUS[] = {5, 10, 15, 20, 25, 30, MAX_DIMENSAO_GERADOR};
+static const char *TABULEIROS_FIXOS[] = {"j1", "j2", "j3", "j4", "input.txt"};
+
+typedef enum {
+    OP_CARREGAR,
+    OP_RESTRICOES,
+    OP_CONECTIVIDADE,
+    OP_AJUDAR,
+    OP_AJUDA_AUTOMATICA,
+    OP_RESOLVER,
+    NUM_OPERACOES
+} Operacao;
+
+static const char *NOMES_OPERACOES[NUM_OPERACOES] = {
+    "carregarJogo", "verificarRestricoes", "verificarConectividadeBrancas",
+    "ajudar", "ajudaAutomatica", "resolverJogo"
+};
+
+
+// Corpo gerado ========================================================================================
+
+// Gera o tabuleiro n x n do corpo com o gerador de tabuleiros de solução única, sempre com a mesma
+// semente, e confirma a unicidade com o resolvedor antes de o gravar: um tabuleiro sem solução só
+// mediria a deteção da contradição. Devolve -1 se não for possível gerar um tabuleiro válido.
+static int gerarTabuleiro(int n, const char *arquivo) {
+    ParametrosGerador parametros = {n, n, 40, 1};
+    uint64_t estado = 0x9E3779B97F4A7C15ULL ^ (uint64_t)n;
+
+    Jogo *jogo = gerarJogoUnico(&parametros, &estado);
+    int valido = jogo && contarSolucoes(jogo, 2, NULL, NULL) == 1;
+    int resultado = valido ? gravarTabuleiroGerado(jogo, arquivo) : -1;
+    freeJogo(jogo);
+    return resultado;
+}
+
+
+// Medição =============================================================================================
+
+static double agoraUs(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+static int compararTempos(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nós da procura do resolvedor com a heurística atual (fora da medição de tempo)
+static long contarNos(char *arquivo) {
+    Jogo *jogo = carregarJogo(arquivo);
+    if (!jogo) return -1;
+    EstatisticasResolver estatisticas = {0};
+    resolverComPropagacao(jogo, &estatisticas);
+    freeJogo(jogo);
+    return estatisticas.nos;
+}
+
+// Mede uma amostra da operação; as operações que alteram o tabuleiro usam sempre um jogo acabado de carregar
+static double medirOperacao(Operacao operacao, char *arquivo) {
+    double inicio, fim;
+
+    if (operacao == OP_CARREGAR) {
+        inicio = agoraUs();
+        Jogo *jogo = carregarJogo(arquivo);
+        fim = agoraUs();
+        freeJogo(jogo);
+        return jogo ? fim - inicio : -1;
+    }
+
+    Jogo *jogo = carregarJogo(arquivo);
+    if (!jogo) return -1;
+
+    inicio = agoraUs();
+    switch (operacao) {
+        case OP_RESTRICOES:       verificarRestricoes(jogo); break;
+        case OP_CONECTIVIDADE:    verificarConectividadeBrancas(jogo); break;
+        case OP_AJUDAR:           ajudar(jogo); break;
+        case OP_AJUDA_AUTOMATICA: processarComandos(&jogo, "A"); break;
+        case OP_RESOLVER:         resolverJogo(jogo); break;
+        default: break;
+    }
+    fim = agoraUs();
+
+    freeJogo(jogo);
+    return fim - inicio;
+}
+
+// A resolução é medida uma vez com cada uma das heurísticas pedidas
+static void medirTabuleiro(FILE *relatorio, char *arquivo, const char *nome, int repeticoes,
+                           const int *heuristicas, int numHeuristicas) {
+    double *amostras = malloc(repeticoes * sizeof(double));
+    if (!amostras) return;
+
+    Jogo *jogo = carregarJogo(arquivo);
+    if (!jogo) {
+        free(amostras);
+        return;
+    }
+    int linhas = jogo->linhas, colunas = jogo->colunas;
+    freeJogo(jogo);
+
+    for (int op = 0; op < NUM_OPERACOES; op++) {
+        int variantes = op == OP_RESOLVER ? numHeuristicas : 1;
+        for (int h = 0; h < variantes; h++) {
+            if (op == OP_RESOLVER) definirHeuristica(heuristicas[h]);
+
+            double soma = 0;
+            int validas = 0;
+            for (int r = 0; r < repeticoes; r++) {
+                double tempo = medirOperacao(op, arquivo);
+                if (tempo < 0) continue;
+                amostras[validas++] = tempo;
+                soma += tempo;
+            }
+            if (validas == 0) continue;
+
+            qsort(amostras, validas, sizeof(double), compararTempos);
+            double mediana = validas % 2 ? amostras[validas / 2]
+                                         : (amostras[validas / 2 - 1] + amostras[validas / 2]) / 2;
+            int p95 = (95 * validas + 99) / 100 - 1;
+            fprintf(relatorio, "%s,%dx%d,%s,%s,%d,%.3f,%.3f,%.1f,", nome, linhas, colunas, NOMES_OPERACOES[op],
+                    op == OP_RESOLVER ? NOMES_HEURISTICAS[heuristicas[h]] : "-",
+                    validas, mediana, amostras[p95], soma > 0 ? validas * 1e6 / soma : 0.0);
+            if (op == OP_RESOLVER) fprintf(relatorio, "%ld", contarNos(arquivo));
+            fprintf(relatorio, "\n");
+            fflush(relatorio);
+        }
+    }
+
+    free(amostras);
+}
+
+// Uso: bench [pasta_corpus] [repeticoes] [heuristica|todas]
+int main(int argc, char *argv[]) {
+    const char *pasta = argc > 1 ? argv[1] : PASTA_CORPUS_PADRAO;
+    int repeticoes = argc > 2 ? atoi(argv[2]) : REPETICOES_PADRAO;
+    if (repeticoes < 1) repeticoes = 1;
+
+    // Por omissão a resolução é medida com todas as heurísticas
+    int heuristicas[NUM_HEURISTICAS];
+    int numHeuristicas = 0;
+    if (argc > 3 && strcmp(argv[3], "todas") != 0) {
+        int h = procurarHeuristica(argv[3]);
+        if (h < 0) {
+            fprintf(stderr, "Heurística desconhecida: %s\n", argv[3]);
+            return 1;
+        }
+        heuristicas[numHeuristicas++] = h;
+    } else {
+        for (int h = 0; h < NUM_HEURISTICAS; h++) heuristicas[numHeuristicas++] = h;
+    }
+
+    if (mkdir(pasta, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "Erro ao criar a pasta %s\n", pasta);
+        return 1;
+    }
+
+    // O relatório continua no stdout original; o resto do texto das funções do jogo é descartado
+    FILE *relatorio = fdopen(dup(STDOUT_FILENO), "w");
+    if (!relatorio || !freopen("/dev/null", "w", stdout)) {
+        fprintf(stderr, "Erro ao preparar o relatório.\n");
+        return 1;
+    }
+
+    fprintf(relatorio, "tabuleiro,dimensao,operacao,heuristica,amostras,mediana_us,p95_us,ops_por_segundo,nos\n");
+
+    char arquivo[MAX_CAMINHO];
+    for (size_t k = 0; k < sizeof(DIMENSOES_CORPUS) / sizeof(DIMENSOES_CORPUS[0]); k++) {
+        int n = DIMENSOES_CORPUS[k];
+        snprintf(arquivo, sizeof(arquivo), "%s/gerado_%dx%d.txt", pasta, n, n);
+        if (gerarTabuleiro(n, arquivo) != 0) {
+            fprintf(stderr, "Erro ao gerar %s: sem tabuleiro de solução única\n", arquivo);
+            fclose(relatorio);
+            return 1;
+        }
+        medirTabuleiro(relatorio, arquivo, arquivo + strlen(pasta) + 1, repeticoes, heuristicas, numHeuristicas);
+    }
+
+    for (size_t k = 0; k < sizeof(TABULEIROS_FIXOS) / sizeof(TABULEIROS_FIXOS[0]); k++) {
+        snprintf(arquivo, sizeof(arquivo), "%s", TABULEIROS_FIXOS[k]);
+        if (access(arquivo, R_OK) == 0) medirTabuleiro(relatorio, arquivo, TABULEIROS_FIXOS[k], repeticoes, heuristicas, numHeuristicas);
+    }
+
+    fclose(relatorio);
+    return 0;
+}
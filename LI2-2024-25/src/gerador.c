@@ -0,0 +1,431 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include "../include/jogo.h"
+#include "../include/resolver.h"
+#include "../include/gerador.h"
+
+#define MAX_REPARACOES 200
+#define MAX_REINICIOS 1000
+#define FOLGA_LETRAS 2            // Letras livres que se tenta deixar em cada linha longa
+#define MAX_TROCAS_LETRAS 50      // Trocas de letra por casa para desfazer as repetições
+#define TAMANHO_CAMINHO 1024
+
+// xorshift64: cada tabuleiro tem o seu estado, por isso o resultado não depende das threads
+static uint32_t aleatorio(uint64_t *estado) {
+    *estado ^= *estado << 13;
+    *estado ^= *estado >> 7;
+    *estado ^= *estado << 17;
+    return (uint32_t)(*estado >> 32);
+}
+
+static int temRiscadaAdjacente(Jogo *jogo, int linha, int coluna) {
+    int p = INDICE_CELULA(jogo, linha, coluna);
+    for (int d = 0; d < 4; d++) {
+        if (jogo->celulas[p + jogo->deslocamentos[d]] == '#') return 1;
+    }
+    return 0;
+}
+
+// A letra de uma riscada é copiada de uma branca da sua linha ou coluna (ver atribuirLetras)
+static int temBrancaNaLinhaOuColuna(Jogo *jogo, int linha, int coluna) {
+    for (int t = 0; t < jogo->colunas; t++) {
+        if (t != coluna && jogo->tabuleiro[linha][t] != '#') return 1;
+    }
+    for (int t = 0; t < jogo->linhas; t++) {
+        if (t != linha && jogo->tabuleiro[t][coluna] != '#') return 1;
+    }
+    return 0;
+}
+
+static int podeRiscar(Jogo *jogo, int linha, int coluna) {
+    return !temRiscadaAdjacente(jogo, linha, coluna) && temBrancaNaLinhaOuColuna(jogo, linha, coluna) &&
+           !riscarSepararia(jogo, linha, coluna);
+}
+
+
+// Solução pretendida ==================================================================================
+
+// Risca casas ao acaso sem riscadas adjacentes nem brancas separadas; a união de riscadas
+// do próprio jogo responde à conectividade em tempo quase constante
+static void gerarPadrao(Jogo *padrao, int densidade, uint64_t *estado, int *ordem) {
+    int total = padrao->linhas * padrao->colunas;
+    for (int k = 0; k < total; k++) ordem[k] = k;
+    for (int k = total - 1; k > 0; k--) {
+        int t = aleatorio(estado) % (k + 1), aux = ordem[k];
+        ordem[k] = ordem[t];
+        ordem[t] = aux;
+    }
+
+    for (int k = 0; k < total; k++) {
+        int i = ordem[k] / padrao->colunas, j = ordem[k] % padrao->colunas;
+        if ((int)(aleatorio(estado) % 100) < densidade && podeRiscar(padrao, i, j)) {
+            alterarCelula(padrao, i, j, '#');
+        }
+    }
+}
+
+// Cada linha e coluna só tem NUM_LETRAS letras diferentes para as suas brancas: nas linhas com
+// mais de NUM_LETRAS - FOLGA_LETRAS brancas risca casas ao acaso (sem riscadas adjacentes nem
+// brancas separadas). A folga deixa escolha às letras; sem ela, as linhas com exatamente
+// NUM_LETRAS brancas raramente se conseguem preencher. Devolve -1 se alguma linha ou coluna
+// ficar com mais de NUM_LETRAS brancas.
+static int limitarBrancas(Jogo *padrao, uint64_t *estado, int *ordem) {
+    int linhas = padrao->linhas, colunas = padrao->colunas, total = linhas * colunas;
+    int brancasLinha[MAX_DIMENSAO] = {0}, brancasColuna[MAX_DIMENSAO] = {0};
+
+    for (int i = 0; i < linhas; i++) {
+        for (int j = 0; j < colunas; j++) {
+            if (padrao->tabuleiro[i][j] != '#') {
+                brancasLinha[i]++;
+                brancasColuna[j]++;
+            }
+        }
+    }
+
+    // Primeiro as casas em excesso na linha e na coluna, depois as que estão só numa delas
+    for (int passagem = 0; passagem < 2; passagem++) {
+        int inicio = aleatorio(estado) % total;
+        for (int c = 0; c < total; c++) {
+            int i = ordem[(inicio + c) % total] / colunas, j = ordem[(inicio + c) % total] % colunas;
+            int excesso = (brancasLinha[i] > NUM_LETRAS - FOLGA_LETRAS) + (brancasColuna[j] > NUM_LETRAS - FOLGA_LETRAS);
+            if (excesso > 1 - passagem && padrao->tabuleiro[i][j] != '#' && podeRiscar(padrao, i, j)) {
+                alterarCelula(padrao, i, j, '#');
+                brancasLinha[i]--;
+                brancasColuna[j]--;
+            }
+        }
+    }
+
+    for (int i = 0; i < linhas; i++) if (brancasLinha[i] > NUM_LETRAS) return -1;
+    for (int j = 0; j < colunas; j++) if (brancasColuna[j] > NUM_LETRAS) return -1;
+    return 0;
+}
+
+// Letra para a branca (i, j) diferente da atual e com menos repetições na linha e na coluna
+static int letraMenosRepetida(unsigned char naLinha[][NUM_LETRAS], unsigned char naColuna[][NUM_LETRAS],
+                              int i, int j, int atual, uint64_t *estado) {
+    int inicio = aleatorio(estado) % NUM_LETRAS, melhor = -1, menor = 0;
+    for (int c = 0; c < NUM_LETRAS; c++) {
+        int letra = (inicio + c) % NUM_LETRAS;
+        int repeticoes = naLinha[i][letra] + naColuna[j][letra];
+        if (letra != atual && (melhor < 0 || repeticoes < menor)) {
+            melhor = letra;
+            menor = repeticoes;
+        }
+    }
+    return melhor;
+}
+
+// Dá às brancas letras sem repetições por linha e coluna e a cada riscada a letra de uma branca
+// da sua linha ou coluna. Uma branca sem letra livre é riscada, se possível; senão fica com a letra
+// menos repetida e as repetições são desfeitas no fim, mudando de letra uma das brancas repetidas
+// de cada vez (sem isto, a partir de cerca de 30x30 quase nenhum padrão recebia letras).
+// Devolve -1 se falhar.
+static int atribuirLetras(Jogo *padrao, char *letras, uint64_t *estado, int *ordem) {
+    int linhas = padrao->linhas, colunas = padrao->colunas, total = linhas * colunas;
+    unsigned char naLinha[MAX_DIMENSAO][NUM_LETRAS] = {{0}};
+    unsigned char naColuna[MAX_DIMENSAO][NUM_LETRAS] = {{0}};
+    if (limitarBrancas(padrao, estado, ordem) != 0) return -1;
+
+    // Brancas com letra repetida, por reparar (cada casa no máximo uma vez na pilha)
+    int *pendentes = malloc(total * sizeof(int));
+    char *naPilha = calloc(total, 1);
+    int numPendentes = 0;
+    if (!pendentes || !naPilha) {
+        free(pendentes);
+        free(naPilha);
+        return -1;
+    }
+
+    for (int i = 0; i < linhas; i++) {
+        for (int j = 0; j < colunas; j++) {
+            if (padrao->tabuleiro[i][j] == '#') continue;
+
+            uint32_t livres = 0;
+            for (int l = 0; l < NUM_LETRAS; l++) {
+                if (naLinha[i][l] + naColuna[j][l] == 0) livres |= 1u << l;
+            }
+            int letra;
+            if (livres) {
+                letra = aleatorio(estado) % NUM_LETRAS;
+                while (!(livres & (1u << letra))) letra = (letra + 1) % NUM_LETRAS;
+            } else if (podeRiscar(padrao, i, j)) {
+                alterarCelula(padrao, i, j, '#');
+                continue;
+            } else {
+                letra = letraMenosRepetida(naLinha, naColuna, i, j, -1, estado);
+                pendentes[numPendentes++] = i * colunas + j;
+                naPilha[i * colunas + j] = 1;
+            }
+
+            letras[i * colunas + j] = 'a' + letra;
+            naLinha[i][letra]++;
+            naColuna[j][letra]++;
+        }
+    }
+
+    for (int passo = 0; numPendentes > 0 && passo < MAX_TROCAS_LETRAS * total; passo++) {
+        int k = pendentes[--numPendentes], i = k / colunas, j = k % colunas, letra = letras[k] - 'a';
+        naPilha[k] = 0;
+        if (naLinha[i][letra] < 2 && naColuna[j][letra] < 2) continue;
+
+        int nova = letraMenosRepetida(naLinha, naColuna, i, j, letra, estado);
+        naLinha[i][letra]--;
+        naColuna[j][letra]--;
+        naLinha[i][nova]++;
+        naColuna[j][nova]++;
+        letras[k] = 'a' + nova;
+
+        // As brancas que passaram a repetir a nova letra ficam por reparar, tal como esta
+        for (int t = 0; t < linhas + colunas; t++) {
+            int q = t < colunas ? i * colunas + t : (t - colunas) * colunas + j;
+            if (!naPilha[q] && padrao->tabuleiro[q / colunas][q % colunas] != '#' && letras[q] == 'a' + nova &&
+                (naLinha[i][nova] > 1 || naColuna[j][nova] > 1)) {
+                pendentes[numPendentes++] = q;
+                naPilha[q] = 1;
+            }
+        }
+    }
+    int reparado = numPendentes == 0;
+    free(pendentes);
+    free(naPilha);
+    if (!reparado) return -1;
+
+    for (int i = 0; i < linhas; i++) {
+        for (int j = 0; j < colunas; j++) {
+            if (padrao->tabuleiro[i][j] != '#') continue;
+
+            // Riscadas não são adjacentes nem a única casa do tabuleiro: há sempre uma branca vizinha
+            int k;
+            do {
+                if (aleatorio(estado) % 2) {
+                    k = i * colunas + aleatorio(estado) % colunas;
+                } else {
+                    k = (aleatorio(estado) % linhas) * colunas + j;
+                }
+            } while (padrao->tabuleiro[k / colunas][k % colunas] == '#');
+            letras[i * colunas + j] = letras[k];
+        }
+    }
+    return 0;
+}
+
+
+// Unicidade ===========================================================================================
+
+// Elimina a solução alternativa dando a uma casa riscada na pretendida e branca na alternativa
+// a letra de uma branca comum às duas. Se as riscadas pretendidas estão todas riscadas na
+// alternativa, nenhuma letra a elimina: a alternativa passa a ser a solução pretendida.
+// Devolve -1 se não houver reparação possível.
+static int repararAmbiguidade(Jogo *jogo, Jogo *padrao, const char *alternativa, uint64_t *estado) {
+    int linhas = jogo->linhas, colunas = jogo->colunas;
+    int candidatas[MAX_DIMENSAO * MAX_DIMENSAO];
+    int numCandidatas = 0;
+
+    for (int i = 0; i < linhas; i++) {
+        for (int j = 0; j < colunas; j++) {
+            if (padrao->tabuleiro[i][j] == '#' && alternativa[INDICE_CELULA(jogo, i, j)] != '#') {
+                candidatas[numCandidatas++] = i * colunas + j;
+            }
+        }
+    }
+
+    if (numCandidatas == 0) {
+        for (int i = 0; i < linhas; i++) {
+            for (int j = 0; j < colunas; j++) {
+                if (alternativa[INDICE_CELULA(jogo, i, j)] == '#') alterarCelula(padrao, i, j, '#');
+            }
+        }
+        return 0;
+    }
+
+    // Começar numa candidata ao acaso e usar a primeira que tenha uma branca comum na linha ou coluna
+    int inicio = aleatorio(estado) % numCandidatas;
+    for (int c = 0; c < numCandidatas; c++) {
+        int k = candidatas[(inicio + c) % numCandidatas];
+        int i = k / colunas, j = k % colunas;
+        int comuns[2 * MAX_DIMENSAO];
+        int numComuns = 0;
+
+        for (int t = 0; t < colunas; t++) {
+            if (padrao->tabuleiro[i][t] != '#' && alternativa[INDICE_CELULA(jogo, i, t)] != '#') comuns[numComuns++] = i * colunas + t;
+        }
+        for (int t = 0; t < linhas; t++) {
+            if (padrao->tabuleiro[t][j] != '#' && alternativa[INDICE_CELULA(jogo, t, j)] != '#') comuns[numComuns++] = t * colunas + j;
+        }
+        if (numComuns == 0) continue;
+
+        int escolhida = comuns[aleatorio(estado) % numComuns];
+        alterarCelula(jogo, i, j, jogo->tabuleiro[escolhida / colunas][escolhida % colunas]);
+        return 0;
+    }
+    return -1;
+}
+
+static int mesmasRiscadas(const char *a, const char *b, int tamanho) {
+    for (int p = 0; p < tamanho; p++) {
+        if ((a[p] == '#') != (b[p] == '#')) return 0;
+    }
+    return 1;
+}
+
+// Verifica a unicidade com o resolvedor e repara até a solução pretendida ser a única.
+// Devolve 1 se o jogo ficou com solução única e 0 se for preciso recomeçar.
+static int tornarUnico(Jogo *jogo, Jogo *padrao, char **solucoes, uint64_t *estado) {
+    int tamanho = (jogo->linhas + 2) * jogo->largura;
+
+    for (int r = 0; r < MAX_REPARACOES; r++) {
+        int encontradas = contarSolucoes(jogo, 2, solucoes, NULL);
+        if (encontradas == 1) return 1;
+        if (encontradas != 2) return 0;
+
+        // Uma das duas soluções encontradas não é a pretendida
+        const char *alternativa = mesmasRiscadas(solucoes[0], padrao->celulas, tamanho) ? solucoes[1] : solucoes[0];
+        if (repararAmbiguidade(jogo, padrao, alternativa, estado) != 0) return 0;
+    }
+    return 0;
+}
+
+Jogo* gerarJogoUnico(const ParametrosGerador *parametros, uint64_t *estado) {
+    if (!parametros || !estado) return NULL;
+    int linhas = parametros->linhas, colunas = parametros->colunas;
+    if (linhas < 1 || linhas > MAX_DIMENSAO_GERADOR || colunas < 1 || colunas > MAX_DIMENSAO_GERADOR) return NULL;
+
+    int total = linhas * colunas;
+    char *letras = malloc(total);
+    int *ordem = malloc(total * sizeof(int));
+    if (!letras || !ordem) {
+        free(letras);
+        free(ordem);
+        return NULL;
+    }
+    memset(letras, 'a', total);
+
+    Jogo *resultado = NULL;
+    for (int tentativa = 0; tentativa < MAX_REINICIOS && !resultado; tentativa++) {
+        Jogo *padrao = criarJogo(linhas, colunas, letras);
+        if (!padrao) break;
+
+        gerarPadrao(padrao, parametros->densidade, estado, ordem);
+        if (atribuirLetras(padrao, letras, estado, ordem) == 0) {
+            Jogo *jogo = criarJogo(linhas, colunas, letras);
+            int tamanho = (linhas + 2) * padrao->largura;
+            char *solucoes[2] = { malloc(tamanho), malloc(tamanho) };
+
+            if (jogo && solucoes[0] && solucoes[1] && tornarUnico(jogo, padrao, solucoes, estado)) {
+                // A reparação mudou letras depois de criarJogo: o tabuleiro inicial passa a ser o final
+                memcpy(jogo->inicial, jogo->celulas, (linhas + 2) * jogo->largura);
+                resultado = jogo;
+            } else {
+                freeJogo(jogo);
+            }
+            free(solucoes[0]);
+            free(solucoes[1]);
+        }
+
+        freeJogo(padrao);
+        memset(letras, 'a', total);
+    }
+
+    free(letras);
+    free(ordem);
+    return resultado;
+}
+
+// Mesmo formato que carregarJogo lê, sem histórico
+int gravarTabuleiroGerado(Jogo *jogo, const char *arquivo) {
+    if (!jogo || !arquivo) return -1;
+
+    FILE *output = fopen(arquivo, "w");
+    if (!output) {
+        printf("Erro ao abrir arquivo %s para escrita\n", arquivo);
+        return -1;
+    }
+    fprintf(output, "%d %d\n", jogo->linhas, jogo->colunas);
+    for (int i = 0; i < jogo->linhas; i++) fprintf(output, "%s\n", jogo->tabuleiro[i]);
+    fclose(output);
+    return 0;
+}
+
+
+// Geração em lote =====================================================================================
+
+typedef struct {
+    const char *pasta;
+    int quantidade;
+    const ParametrosGerador *parametros;
+    atomic_int proximo;
+    atomic_int gerados;
+    atomic_int falhados;
+} LoteGerador;
+
+static void* trabalhadorGerador(void *argumento) {
+    LoteGerador *lote = argumento;
+    char arquivo[TAMANHO_CAMINHO];
+
+    int k;
+    while ((k = atomic_fetch_add(&lote->proximo, 1)) < lote->quantidade) {
+        // A semente de cada tabuleiro só depende da semente global e do índice
+        uint64_t estado = (lote->parametros->semente + 1) * 0x9E3779B97F4A7C15ULL ^ ((uint64_t)(k + 1) << 32 | (uint64_t)(k + 1));
+        if (estado == 0) estado = 1;
+
+        Jogo *jogo = gerarJogoUnico(lote->parametros, &estado);
+        snprintf(arquivo, sizeof(arquivo), "%s/hitori_%dx%d_%05d.txt", lote->pasta,
+                 lote->parametros->linhas, lote->parametros->colunas, k);
+        if (jogo && gravarTabuleiroGerado(jogo, arquivo) == 0) {
+            atomic_fetch_add(&lote->gerados, 1);
+        } else {
+            atomic_fetch_add(&lote->falhados, 1);
+        }
+        freeJogo(jogo);
+    }
+    return NULL;
+}
+
+// Devolve o número de tabuleiros gerados ou -1 em erro
+int gerarLoteTabuleiros(const char *pasta, int quantidade, const ParametrosGerador *parametros, int numThreads) {
+    if (!pasta || !parametros || quantidade < 0) return -1;
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > MAX_THREADS) numThreads = MAX_THREADS;
+
+    if (mkdir(pasta, 0755) != 0 && errno != EEXIST) {
+        printf("Erro ao criar a pasta %s\n", pasta);
+        return -1;
+    }
+
+    LoteGerador lote;
+    lote.pasta = pasta;
+    lote.quantidade = quantidade;
+    lote.parametros = parametros;
+    atomic_init(&lote.proximo, 0);
+    atomic_init(&lote.gerados, 0);
+    atomic_init(&lote.falhados, 0);
+
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+
+    pthread_t threads[MAX_THREADS];
+    int criadas = 0;
+    for (int t = 1; t < numThreads; t++) {
+        if (pthread_create(&threads[criadas], NULL, trabalhadorGerador, &lote) != 0) break;
+        criadas++;
+    }
+    trabalhadorGerador(&lote);
+    for (int t = 0; t < criadas; t++) pthread_join(threads[t], NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    int gerados = atomic_load(&lote.gerados);
+
+    printf("Gerados %d tabuleiros %dx%d (%d falhados) em %.3f s com %d threads (%.1f por minuto)\n",
+           gerados, parametros->linhas, parametros->colunas, atomic_load(&lote.falhados), segundos,
+           criadas + 1, segundos > 0 ? gerados * 60.0 / segundos : 0.0);
+
+    return gerados;
+}
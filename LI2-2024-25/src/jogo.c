@@ -3,9 +3,98 @@
 #include <ctype.h>
 #include <string.h>
 #include "../include/jogo.h"
+#include "../include/resolver.h"
+#include "../include/regras.h"
 
 // Funções etapa 1 ===================================================================================
 
+// Reserva o vetor contíguo do tabuleiro (com a moldura de sentinelas) e a vista por linhas
+static int alocarTabuleiro(Jogo *jogo) {
+    jogo->largura = jogo->colunas + 1;
+    jogo->deslocamentos[0] = -jogo->largura;
+    jogo->deslocamentos[1] = jogo->largura;
+    jogo->deslocamentos[2] = -1;
+    jogo->deslocamentos[3] = 1;
+
+    jogo->celulas = calloc((jogo->linhas + 2) * jogo->largura, sizeof(char));
+    jogo->tabuleiro = malloc(jogo->linhas * sizeof(char *));
+    if (!jogo->celulas || !jogo->tabuleiro) {
+        free(jogo->celulas);
+        free(jogo->tabuleiro);
+        jogo->celulas = NULL;
+        jogo->tabuleiro = NULL;
+        return -1;
+    }
+
+    for (int i = 0; i < jogo->linhas; i++) {
+        jogo->tabuleiro[i] = jogo->celulas + INDICE_CELULA(jogo, i, 0);
+    }
+    return 0;
+}
+
+// Pontos de restauro do histórico -----------------------------------------------------------------
+
+static EstadoCasa estadoCasa(char valor) {
+    if (valor == '#') return CASA_RISCADA;
+    return (valor >= 'A' && valor <= 'Z') ? CASA_BRANCA : CASA_POR_DECIDIR;
+}
+
+// Valor da casa na posição p do vetor do tabuleiro com o estado dado; a letra vem do tabuleiro inicial
+static char valorCasa(Jogo *jogo, int p, EstadoCasa estado) {
+    char letra = jogo->inicial[p];
+    if (estado == CASA_RISCADA || letra == '#') return '#';
+    return estado == CASA_BRANCA ? toupper(letra) : tolower(letra);
+}
+
+static EstadoCasa estadoNoPonto(const uint8_t *ponto, int q) {
+    return (ponto[q / 4] >> (2 * (q % 4))) & 3;
+}
+
+static void definirEstadoNoPonto(uint8_t *ponto, int q, EstadoCasa estado) {
+    ponto[q / 4] = (ponto[q / 4] & ~(3 << (2 * (q % 4)))) | (estado << (2 * (q % 4)));
+}
+
+// Cria os pontos de restauro que faltam até ao último movimento do histórico: o ponto 0 é o tabuleiro
+// inicial e o ponto p é o ponto p - 1 com os estados posteriores dos movimentos seguintes. Sem
+// memória ficam só os pontos que já havia.
+static void atualizarPontos(Jogo *jogo) {
+    HistoricoMovimentos *historico = &jogo->historico;
+    if (!jogo->inicial) return;
+
+    int necessarios = historico->fim / INTERVALO_PONTOS + 1;
+    if (historico->numPontos >= necessarios) return;
+
+    int bytes = (jogo->linhas * jogo->colunas + 3) / 4;
+    if (necessarios > historico->capacidadePontos) {
+        int capacidade = historico->capacidadePontos ? 2 * historico->capacidadePontos : 8;
+        while (capacidade < necessarios) capacidade *= 2;
+        uint8_t *pontos = realloc(historico->pontos, (size_t)capacidade * bytes);
+        if (!pontos) return;
+        historico->pontos = pontos;
+        historico->capacidadePontos = capacidade;
+    }
+
+    if (historico->numPontos == 0) {
+        memset(historico->pontos, 0, bytes);
+        for (int i = 0; i < jogo->linhas; i++) {
+            for (int j = 0; j < jogo->colunas; j++) {
+                definirEstadoNoPonto(historico->pontos, i * jogo->colunas + j, estadoCasa(jogo->inicial[INDICE_CELULA(jogo, i, j)]));
+            }
+        }
+        historico->numPontos = 1;
+    }
+
+    while (historico->numPontos < necessarios) {
+        uint8_t *ponto = historico->pontos + (size_t)historico->numPontos * bytes;
+        memcpy(ponto, ponto - bytes, bytes);
+        for (int k = (historico->numPontos - 1) * INTERVALO_PONTOS; k < historico->numPontos * INTERVALO_PONTOS; k++) {
+            Movimento *movimento = &historico->movimentos[k];
+            definirEstadoNoPonto(ponto, movimento->linha * jogo->colunas + movimento->coluna, movimento->estadoPosterior);
+        }
+        historico->numPontos++;
+    }
+}
+
 Jogo* carregarJogo(char *arquivo) {
     FILE *input = fopen(arquivo, "r");
     if (!input) {
@@ -21,10 +110,13 @@ Jogo* carregarJogo(char *arquivo) {
     }
     
     // Inicializa o histórico de movimentos
-    jogo->historicoMovimentos = NULL;
+    jogo->historico = (HistoricoMovimentos){ .inicioGrupo = -1 };
     jogo->modoAjudaAtiva = 0; // Desativado por padrão
-    jogo->agrupandoMovimentos = 0;
-    jogo->grupoMovimentos = NULL;
+    jogo->mascaras = NULL;
+    jogo->uniao = NULL;
+    jogo->trabalho = NULL;
+    jogo->arena = NULL;
+    jogo->inicial = NULL;
 
 
     // Lê as dimensões do tabuleiro
@@ -35,29 +127,22 @@ Jogo* carregarJogo(char *arquivo) {
         return NULL;
     }
 
-    // Aloca memória para o tabuleiro
-    jogo->tabuleiro = malloc(jogo->linhas * sizeof(char *));
-    if (!jogo->tabuleiro) {
-        printf("Erro na alocação de memória para o tabuleiro.\n");
+    if (jogo->linhas < 1 || jogo->linhas > MAX_DIMENSAO || jogo->colunas < 1 || jogo->colunas > MAX_DIMENSAO) {
+        printf("Dimensões do tabuleiro não suportadas (máximo %dx%d).\n", MAX_DIMENSAO, MAX_DIMENSAO);
         free(jogo);
         fclose(input);
         return NULL;
     }
 
-    // Aloca memória para cada linha do tabuleiro e lê cada caractere
-    for (int i = 0; i < jogo->linhas; i++) {
-    jogo->tabuleiro[i] = malloc((jogo->colunas + 1) * sizeof(char)); // +1 para '\0'
-    if (!jogo->tabuleiro[i]) {
-        printf("Erro na alocação de memória para a linha %d.\n", i);
-        for (int j = 0; j < i; j++) {
-            free(jogo->tabuleiro[j]);
-        }
-        free(jogo->tabuleiro);
+    // Aloca memória para o tabuleiro e lê cada caractere
+    if (alocarTabuleiro(jogo) != 0) {
+        printf("Erro na alocação de memória para o tabuleiro.\n");
         free(jogo);
         fclose(input);
         return NULL;
     }
 
+    for (int i = 0; i < jogo->linhas; i++) {
     for (int j = 0; j < jogo->colunas; j++) {
         int ch = fgetc(input);
         if (ch == EOF || ch == '\n') {
@@ -68,7 +153,6 @@ Jogo* carregarJogo(char *arquivo) {
             jogo->tabuleiro[i][j] = (char)ch;
         }
     }
-    jogo->tabuleiro[i][jogo->colunas] = '\0';
 
     int ch;
     do {
@@ -78,8 +162,64 @@ Jogo* carregarJogo(char *arquivo) {
 
     // Carrega o histórico de movimentos, se existir
     carregarHistoricoMovimentos(input, jogo);
-
     fclose(input);
+
+    jogo->mascaras = criarMascaras(jogo);
+    jogo->uniao = criarUniaoRiscadas(jogo);
+    jogo->inicial = malloc((jogo->linhas + 2) * jogo->largura);
+    if (!jogo->mascaras || !jogo->uniao || !jogo->inicial) {
+        printf("Erro na alocação de memória para as estruturas do tabuleiro.\n");
+        freeJogo(jogo);
+        return NULL;
+    }
+
+    // O tabuleiro inicial é o carregado com os movimentos do histórico desfeitos, do mais recente para o
+    // mais antigo; antes de desfazer cada movimento, a sua casa tem o estado posterior a ele
+    memcpy(jogo->inicial, jogo->celulas, (jogo->linhas + 2) * jogo->largura);
+    for (int k = jogo->historico.numMovimentos - 1; k >= 0; k--) {
+        Movimento *movimento = &jogo->historico.movimentos[k];
+        int p = INDICE_CELULA(jogo, movimento->linha, movimento->coluna);
+        movimento->estadoPosterior = estadoCasa(jogo->inicial[p]);
+        jogo->inicial[p] = movimento->estadoAnterior;
+    }
+    atualizarPontos(jogo);
+
+    return jogo;
+}
+
+// Cria um jogo sem histórico a partir de linhas*colunas casas, linha a linha
+Jogo* criarJogo(int linhas, int colunas, const char *casas) {
+    if (!casas || linhas < 1 || linhas > MAX_DIMENSAO || colunas < 1 || colunas > MAX_DIMENSAO) return NULL;
+
+    Jogo *jogo = malloc(sizeof(Jogo));
+    if (!jogo) return NULL;
+
+    jogo->linhas = linhas;
+    jogo->colunas = colunas;
+    jogo->historico = (HistoricoMovimentos){ .inicioGrupo = -1 };
+    jogo->modoAjudaAtiva = 0;
+    jogo->mascaras = NULL;
+    jogo->uniao = NULL;
+    jogo->trabalho = NULL;
+    jogo->arena = NULL;
+    jogo->inicial = NULL;
+
+    if (alocarTabuleiro(jogo) != 0) {
+        free(jogo);
+        return NULL;
+    }
+    for (int i = 0; i < linhas; i++) {
+        memcpy(jogo->tabuleiro[i], casas + i * colunas, colunas);
+    }
+
+    jogo->mascaras = criarMascaras(jogo);
+    jogo->uniao = criarUniaoRiscadas(jogo);
+    jogo->inicial = malloc((linhas + 2) * jogo->largura);
+    if (!jogo->mascaras || !jogo->uniao || !jogo->inicial) {
+        freeJogo(jogo);
+        return NULL;
+    }
+    memcpy(jogo->inicial, jogo->celulas, (linhas + 2) * jogo->largura);
     return jogo;
 }
 
@@ -89,57 +229,49 @@ void carregarHistoricoMovimentos(FILE *input, Jogo *jogo) {
     if (fscanf(input, "%d\n", &numMovimentos) != 1) {
         return; // Não há histórico de movimentos no arquivo
     }
+    if (numMovimentos <= 0) return;
     
     printf("Carregando %d movimentos do histórico...\n", numMovimentos);
     
-    Movimento **movimentosTemp = NULL;
-    if (numMovimentos > 0) {
-        movimentosTemp = malloc(numMovimentos * sizeof(Movimento*));
-        if (!movimentosTemp) {
-            printf("Erro na alocação de memória para movimentos temporários.\n");
-            return;
-        }
-
-        for (int i = 0; i < numMovimentos; i++) {
-            movimentosTemp[i] = NULL;
-        }
+    HistoricoMovimentos *historico = &jogo->historico;
+    historico->movimentos = malloc(numMovimentos * sizeof(Movimento));
+    if (!historico->movimentos) {
+        printf("Erro na alocação de memória para o histórico.\n");
+        return;
     }
+    historico->capacidade = numMovimentos;
     
-    // Lê cada movimento do histórico
-    int erroLeitura = 0;
-    for (int i = 0; i < numMovimentos && !erroLeitura; i++) {
+    // O arquivo tem os movimentos do mais recente para o mais antigo: preenche o vetor do fim para
+    // o início. Cada linha tem "linha coluna estado" e, nos movimentos de um grupo, a marca 'G'
+    // (início do grupo) ou 'g'. Os ficheiros antigos marcam os grupos com linhas "-1 -1 <c>", que
+    // contam no total do ficheiro mas não são movimentos: são saltadas.
+    int lidos = 0;
+    char linhaArquivo[64];
+    for (int k = 0; k < numMovimentos && fgets(linhaArquivo, sizeof(linhaArquivo), input); k++) {
         int linha, coluna;
-        char estadoAnterior;
-
-        if (fscanf(input, "%d %d %c\n", &linha, &coluna, &estadoAnterior) == 3) {
-            Movimento *novoMovimento = malloc(sizeof(Movimento));
-            if (!novoMovimento) {
-                printf("Erro na alocação de memória para o movimento %d.\n", i);
-            } else {
-                novoMovimento->linha = linha;
-                novoMovimento->coluna = coluna;
-                novoMovimento->estadoAnterior = estadoAnterior;
-                novoMovimento->proximo = NULL;
-                movimentosTemp[i] = novoMovimento;
-            }
-        } else {
-            printf("Erro ao ler o movimento %d do histórico.\n", i);
-            erroLeitura = 1;
+        char estadoAnterior, marca = 0;
+        int campos = sscanf(linhaArquivo, "%d %d %c %c", &linha, &coluna, &estadoAnterior, &marca);
+        if (campos >= 3 && linha == -1 && coluna == -1) continue;
+        if (campos < 3 || linha < 0 || linha >= jogo->linhas || coluna < 0 || coluna >= jogo->colunas) {
+            printf("Erro ao ler o movimento %d do histórico.\n", lidos);
+            break;
         }
+        
+        Movimento *movimento = &historico->movimentos[numMovimentos - 1 - lidos];
+        movimento->linha = linha;
+        movimento->coluna = coluna;
+        movimento->estadoAnterior = estadoAnterior;
+        movimento->grupo = marca == 'G' ? MOVIMENTO_INICIO_GRUPO : marca == 'g' ? MOVIMENTO_GRUPO : MOVIMENTO_SIMPLES;
+        lidos++;
     }
     
-    if (movimentosTemp) {
-        for (int i = 0; i < numMovimentos; i++) {
-            if (movimentosTemp[i]) {
-                int idx = numMovimentos - 1 - i;
-                if (idx >= 0 && idx < numMovimentos && movimentosTemp[idx]) {
-                    movimentosTemp[idx]->proximo = jogo->historicoMovimentos;
-                    jogo->historicoMovimentos = movimentosTemp[idx];
-                }
-            }
-        }
-        free(movimentosTemp);
+    // Com marcas saltadas ou um erro de leitura ficam só os movimentos lidos (os mais recentes),
+    // que passam para o início do vetor
+    if (lidos < numMovimentos) {
+        memmove(historico->movimentos, historico->movimentos + numMovimentos - lidos, lidos * sizeof(Movimento));
     }
+    historico->numMovimentos = lidos;
+    historico->fim = lidos;
 }
 
 
@@ -164,22 +296,16 @@ int gravarJogo(Jogo *jogo, char *arquivo) {
         fputc('\n', output);
     }
     
-    // Conta quantos movimentos estão no histórico
-    int numMovimentos = 0;
-    Movimento *atual = jogo->historicoMovimentos;
-    while (atual != NULL) {
-        numMovimentos++;
-        atual = atual->proximo;
-    }
-    
     // Escreve o número de movimentos
-    fprintf(output, "%d\n", numMovimentos);
-    
-    // Escreve cada movimento do histórico (do mais recente para o mais antigo)
-    atual = jogo->historicoMovimentos;
-    while (atual != NULL) {
-        fprintf(output, "%d %d %c\n", atual->linha, atual->coluna, atual->estadoAnterior);
-        atual = atual->proximo;
+    fprintf(output, "%d\n", numeroMovimentos(jogo));
+    
+    // Escreve cada movimento do histórico (do mais recente para o mais antigo), com a marca de grupo
+    for (int k = jogo->historico.numMovimentos - 1; k >= 0; k--) {
+        Movimento *movimento = &jogo->historico.movimentos[k];
+        fprintf(output, "%d %d %c", movimento->linha, movimento->coluna, movimento->estadoAnterior);
+        if (movimento->grupo == MOVIMENTO_INICIO_GRUPO) fputs(" G", output);
+        else if (movimento->grupo == MOVIMENTO_GRUPO) fputs(" g", output);
+        fputc('\n', output);
     }
     
     fclose(output);
@@ -214,14 +340,9 @@ int pintarBranco(Jogo *jogo, char *coordenada){
         return -1;
     }
     
-    // Regista o movimento antes de alterá-lo
-    registarMovimento(jogo, linha, coluna, jogo->tabuleiro[linha][coluna]);
-    
-    if (jogo->tabuleiro[linha][coluna] >= 'a' && jogo->tabuleiro[linha][coluna] <= 'z') {
-        jogo->tabuleiro[linha][coluna] = jogo->tabuleiro[linha][coluna] - 32; //converter para maiuscula
-    }
-    
-    return 0;
+    char valor = jogo->tabuleiro[linha][coluna];
+    if (valor >= 'a' && valor <= 'z') valor -= 32; //converter para maiuscula
+    return aplicarMovimento(jogo, linha, coluna, valor);
 }
 
 int riscar(Jogo *jogo, char *coordenada) {
@@ -236,204 +357,665 @@ int riscar(Jogo *jogo, char *coordenada) {
         return -1;
     }
     
-    // Regista o movimento antes de alterá-lo
-    registarMovimento(jogo, linha, coluna, jogo->tabuleiro[linha][coluna]);
-    
-    jogo->tabuleiro[linha][coluna] = '#';
-    return 0;
+    return aplicarMovimento(jogo, linha, coluna, '#');
 }
 
 void freeJogo(Jogo *jogo) {
     if (jogo != NULL) {
-        if (jogo->tabuleiro != NULL) {
-            for (int i = 0; i < jogo->linhas; i++) {
-                free(jogo->tabuleiro[i]);
-            }
-            free(jogo->tabuleiro);
-        }
+        free(jogo->tabuleiro);
+        free(jogo->celulas);
+        free(jogo->inicial);
         
         // Liberta a memória do histórico de movimentos
-        freeHistoricoMovimentos(jogo->historicoMovimentos);
+        freeHistoricoMovimentos(&jogo->historico);
+        freeMascaras(jogo->mascaras);
+        freeUniaoRiscadas(jogo->uniao);
+        freeAreaTrabalho(jogo->trabalho);
+        freeArena(jogo->arena);
         
         free(jogo);
     }
 }
 
 
+// Máscaras de bits do tabuleiro ======================================================================
+
+// Índice da letra de uma casa (0-25), ou -1 se a casa está riscada
+static int indiceLetra(char c) {
+    if (c >= 'a' && c <= 'z') return c - 'a';
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    return -1;
+}
+
+// Quantas das quatro vizinhas ortogonais de (linha, coluna) estão marcadas nas máscaras por linha
+static int contarVizinhasNaMascara(Jogo *jogo, const Mascara *porLinha, int linha, int coluna) {
+    Mascara bit = (Mascara)1 << coluna;
+    return __builtin_popcountll(porLinha[linha] & ((bit << 1) | (bit >> 1))) +
+           (linha > 0 && (porLinha[linha - 1] & bit)) +
+           (linha + 1 < jogo->linhas && (porLinha[linha + 1] & bit));
+}
+
+// Recalcula se a casa (linha, coluna) é uma riscada em violação (ver violacoesLinha)
+static void atualizarViolacaoLocal(Jogo *jogo, int linha, int coluna) {
+    MascarasTabuleiro *m = jogo->mascaras;
+    Mascara bit = (Mascara)1 << coluna;
+    int emViolacao = 0;
+
+    if (m->riscadasLinha[linha] & bit) {
+        emViolacao = contarVizinhasNaMascara(jogo, m->indecisasLinha, linha, coluna) > 0 ||
+                     (m->riscadasLinha[linha] & (bit << 1)) ||
+                     (linha + 1 < jogo->linhas && (m->riscadasLinha[linha + 1] & bit));
+    }
+    if (emViolacao) m->violacoesLinha[linha] |= bit; else m->violacoesLinha[linha] &= ~bit;
+}
+
+// Só a casa alterada e as suas vizinhas podem mudar de estado de violação
+static void atualizarViolacoesVizinhanca(Jogo *jogo, int linha, int coluna) {
+    atualizarViolacaoLocal(jogo, linha, coluna);
+    if (linha > 0) atualizarViolacaoLocal(jogo, linha - 1, coluna);
+    if (linha + 1 < jogo->linhas) atualizarViolacaoLocal(jogo, linha + 1, coluna);
+    if (coluna > 0) atualizarViolacaoLocal(jogo, linha, coluna - 1);
+    if (coluna + 1 < jogo->colunas) atualizarViolacaoLocal(jogo, linha, coluna + 1);
+}
+
+// Chave de Zobrist da casa na posição p do vetor com o valor c. Em vez de uma tabela de números
+// aleatórios, a chave sai do finalizador do splitmix64, que tem o mesmo efeito sem memória.
+static uint64_t chaveZobrist(int p, char c) {
+    uint64_t x = ((uint64_t)p << 8 | (unsigned char)c) + 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Adiciona (sinal = 1) ou retira (sinal = 0) a contribuição de uma casa às máscaras
+static void atualizarMascaras(Jogo *jogo, int linha, int coluna, char c, int sinal) {
+    MascarasTabuleiro *m = jogo->mascaras;
+    m->hash ^= chaveZobrist(INDICE_CELULA(jogo, linha, coluna), c);
+    Mascara bitColuna = (Mascara)1 << coluna;
+    Mascara bitLinha = (Mascara)1 << linha;
+    Mascara *estadoLinha = NULL, *estadoColuna = NULL;
+
+    if (c >= 'A' && c <= 'Z') {
+        estadoLinha = &m->brancasLinha[linha];
+        estadoColuna = &m->brancasColuna[coluna];
+    } else if (c >= 'a' && c <= 'z') {
+        estadoLinha = &m->indecisasLinha[linha];
+        estadoColuna = &m->indecisasColuna[coluna];
+    } else if (c == '#') {
+        estadoLinha = &m->riscadasLinha[linha];
+        estadoColuna = &m->riscadasColuna[coluna];
+    }
+
+    int letra = indiceLetra(c);
+    Mascara *letraLinha = letra >= 0 ? &m->letraLinha[letra * jogo->linhas + linha] : NULL;
+    Mascara *letraColuna = letra >= 0 ? &m->letraColuna[letra * jogo->colunas + coluna] : NULL;
+
+    // Contadores: uma letra passa a ser (ou deixa de ser) repetida quando já havia outra igual
+    int variacao = sinal ? 1 : -1;
+    if (letraLinha) {
+        int repetidaLinha = (*letraLinha & ~bitColuna) != 0;
+        int repetidaColuna = (*letraColuna & ~bitLinha) != 0;
+        m->excessoLinha[linha] += variacao * repetidaLinha;
+        m->excessoColuna[coluna] += variacao * repetidaColuna;
+        m->excessoLetras += variacao * (repetidaLinha + repetidaColuna);
+        if (m->excessoLinha[linha]) m->linhasDuplicadas |= bitLinha; else m->linhasDuplicadas &= ~bitLinha;
+        if (m->excessoColuna[coluna]) m->colunasDuplicadas |= bitColuna; else m->colunasDuplicadas &= ~bitColuna;
+    }
+    if (c >= 'a' && c <= 'z') {
+        m->indecisas += variacao;
+        m->paresRiscadaIndecisa += variacao * contarVizinhasNaMascara(jogo, m->riscadasLinha, linha, coluna);
+    } else if (c == '#') {
+        m->paresRiscados += variacao * contarVizinhasNaMascara(jogo, m->riscadasLinha, linha, coluna);
+        m->paresRiscadaIndecisa += variacao * contarVizinhasNaMascara(jogo, m->indecisasLinha, linha, coluna);
+    }
+
+    if (sinal) {
+        if (estadoLinha) { *estadoLinha |= bitColuna; *estadoColuna |= bitLinha; }
+        if (letraLinha) { *letraLinha |= bitColuna; *letraColuna |= bitLinha; }
+    } else {
+        if (estadoLinha) { *estadoLinha &= ~bitColuna; *estadoColuna &= ~bitLinha; }
+        if (letraLinha) { *letraLinha &= ~bitColuna; *letraColuna &= ~bitLinha; }
+    }
+}
+
+MascarasTabuleiro* criarMascaras(Jogo *jogo) {
+    if (!jogo) return NULL;
+
+    int linhas = jogo->linhas, colunas = jogo->colunas;
+    size_t palavras = 4 * (size_t)linhas + 3 * (size_t)colunas + NUM_LETRAS * ((size_t)linhas + colunas);
+
+    MascarasTabuleiro *m = malloc(sizeof(MascarasTabuleiro));
+    if (!m) return NULL;
+    Mascara *dados = calloc(palavras, sizeof(Mascara));
+    int *excessos = calloc((size_t)linhas + colunas, sizeof(int));
+    if (!dados || !excessos) {
+        free(dados);
+        free(excessos);
+        free(m);
+        return NULL;
+    }
+
+    m->brancasLinha = dados;
+    m->riscadasLinha = m->brancasLinha + linhas;
+    m->indecisasLinha = m->riscadasLinha + linhas;
+    m->brancasColuna = m->indecisasLinha + linhas;
+    m->riscadasColuna = m->brancasColuna + colunas;
+    m->indecisasColuna = m->riscadasColuna + colunas;
+    m->letraLinha = m->indecisasColuna + colunas;
+    m->letraColuna = m->letraLinha + NUM_LETRAS * linhas;
+    m->violacoesLinha = m->letraColuna + NUM_LETRAS * colunas;
+    m->linhasDuplicadas = 0;
+    m->colunasDuplicadas = 0;
+    m->paresRiscadaIndecisa = 0;
+    m->excessoLinha = excessos;
+    m->excessoColuna = excessos + linhas;
+    m->excessoLetras = 0;
+    m->indecisas = 0;
+    m->paresRiscados = 0;
+    m->hash = 0;
+
+    MascarasTabuleiro *anterior = jogo->mascaras;
+    jogo->mascaras = m;
+    for (int i = 0; i < linhas; i++) {
+        for (int j = 0; j < colunas; j++) {
+            atualizarMascaras(jogo, i, j, jogo->tabuleiro[i][j], 1);
+        }
+    }
+    for (int i = 0; i < linhas; i++) {
+        for (int j = 0; j < colunas; j++) {
+            atualizarViolacaoLocal(jogo, i, j);
+        }
+    }
+    jogo->mascaras = anterior;
+
+    return m;
+}
+
+void freeMascaras(MascarasTabuleiro *mascaras) {
+    if (mascaras != NULL) {
+        free(mascaras->brancasLinha);
+        free(mascaras->excessoLinha);
+        free(mascaras);
+    }
+}
+
+// Há outra casa branca com a mesma letra na linha?
+int existeOutraBrancaNaLinha(Jogo *jogo, int linha, int coluna, char letra) {
+    int l = indiceLetra(letra);
+    if (l < 0) return 0;
+    MascarasTabuleiro *m = jogo->mascaras;
+    return (m->letraLinha[l * jogo->linhas + linha] & m->brancasLinha[linha] & ~((Mascara)1 << coluna)) != 0;
+}
+
+// Há outra casa branca com a mesma letra na coluna?
+int existeOutraBrancaNaColuna(Jogo *jogo, int linha, int coluna, char letra) {
+    int l = indiceLetra(letra);
+    if (l < 0) return 0;
+    MascarasTabuleiro *m = jogo->mascaras;
+    return (m->letraColuna[l * jogo->colunas + coluna] & m->brancasColuna[coluna] & ~((Mascara)1 << linha)) != 0;
+}
+
+
+// Conectividade incremental das casas riscadas ======================================================
+
+// Posições à volta de uma casa, em sentido horário a partir de cima: N, NE, E, SE, S, SO, O, NO
+static const int anelI[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+static const int anelJ[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+static int raizUniao(UniaoRiscadas *u, int k) {
+    while (u->pai[k] != k) k = u->pai[k];
+    return k;
+}
+
+static void unirRiscadas(UniaoRiscadas *u, int a, int b) {
+    a = raizUniao(u, a);
+    b = raizUniao(u, b);
+    if (a == b) return;
+    if (u->tamanho[a] < u->tamanho[b]) {
+        int t = a; a = b; b = t;
+    }
+    u->pai[b] = a;
+    u->tamanho[a] += u->tamanho[b];
+    u->unioes[u->numUnioes++] = b;
+}
+
+// Nó da posição p do anel de (linha, coluna): a borda, uma riscada, ou -1 se não está riscada
+static int noDoAnel(Jogo *jogo, int linha, int coluna, int p) {
+    int ni = linha + anelI[p], nj = coluna + anelJ[p];
+    int borda = jogo->linhas * jogo->colunas;
+    if (ni < 0 || ni >= jogo->linhas || nj < 0 || nj >= jogo->colunas) return borda;
+    int k = ni * jogo->colunas + nj;
+    return jogo->uniao->pai[k] != -1 ? k : -1;
+}
+
+// Variação do número de regiões não riscadas se (linha, coluna) for riscada.
+// As posições não riscadas do anel ligadas ortogonalmente à casa formam grupos; entre grupos
+// consecutivos há arcos de riscadas. Dois arcos na mesma componente fecham uma curva que separa
+// os grupos entre eles. Sem grupos, a casa era uma região isolada que desaparece.
+static int variacaoComponentes(Jogo *jogo, int linha, int coluna) {
+    UniaoRiscadas *u = jogo->uniao;
+    int no[8], frente[8];
+
+    for (int p = 0; p < 8; p++) no[p] = noDoAnel(jogo, linha, coluna, p);
+    for (int p = 0; p < 8; p++) {
+        // Ortogonais não riscadas, e diagonais não riscadas ao lado de uma ortogonal não riscada
+        frente[p] = no[p] == -1 && (p % 2 == 0 || no[(p + 7) % 8] == -1 || no[(p + 1) % 8] == -1);
+    }
+
+    int inicio = -1;
+    for (int p = 0; p < 8 && inicio == -1; p++) {
+        if (frente[p] && !frente[(p + 1) % 8]) inicio = (p + 1) % 8;
+    }
+    if (inicio == -1) {
+        for (int p = 0; p < 8; p += 2) {
+            if (frente[p]) return 0; // Anel todo não riscado
+        }
+        return -1;
+    }
+
+    int raizes[4], arcos = 0, distintas = 0;
+    for (int q = 0; q < 8; q++) {
+        int p = (inicio + q) % 8;
+        if (frente[p]) continue;
+        if (q > 0 && !frente[(p + 7) % 8]) continue; // Continuação do mesmo arco
+
+        // Primeira riscada do arco (todas as do arco já estão ligadas entre si)
+        int r = p;
+        while (no[r] == -1) r = (r + 1) % 8;
+        int raiz = raizUniao(u, no[r]);
+
+        int repetida = 0;
+        for (int a = 0; a < distintas; a++) {
+            if (raizes[a] == raiz) repetida = 1;
+        }
+        if (!repetida) raizes[distintas++] = raiz;
+        arcos++;
+    }
+
+    return arcos - distintas;
+}
+
+static void inserirRiscada(Jogo *jogo, int linha, int coluna) {
+    UniaoRiscadas *u = jogo->uniao;
+    int k = linha * jogo->colunas + coluna;
+
+    int *registo = &u->riscadas[3 * u->numRiscadas++];
+    registo[0] = k;
+    registo[1] = u->numUnioes;
+    registo[2] = variacaoComponentes(jogo, linha, coluna);
+    u->componentes += registo[2];
+
+    u->pai[k] = k;
+    u->tamanho[k] = 1;
+    for (int p = 0; p < 8; p++) {
+        int vizinho = noDoAnel(jogo, linha, coluna, p);
+        if (vizinho != -1) unirRiscadas(u, k, vizinho);
+    }
+}
+
+static void reconstruirUniaoRiscadas(Jogo *jogo) {
+    UniaoRiscadas *u = jogo->uniao;
+    int total = jogo->linhas * jogo->colunas;
+
+    for (int k = 0; k < total; k++) u->pai[k] = -1;
+    u->pai[total] = total;
+    u->tamanho[total] = 1;
+    u->numUnioes = 0;
+    u->numRiscadas = 0;
+    u->componentes = 1;
+    u->invalida = 0;
+
+    for (int i = 0; i < jogo->linhas; i++) {
+        for (int j = 0; j < jogo->colunas; j++) {
+            if (jogo->tabuleiro[i][j] == '#') inserirRiscada(jogo, i, j);
+        }
+    }
+}
+
+// Retira a riscada mais recente desfazendo as suas uniões; fora de ordem, marca para reconstruir
+static void retirarRiscada(Jogo *jogo, int linha, int coluna) {
+    UniaoRiscadas *u = jogo->uniao;
+    int k = linha * jogo->colunas + coluna;
+
+    if (u->invalida) return;
+    if (u->numRiscadas == 0 || u->riscadas[3 * (u->numRiscadas - 1)] != k) {
+        u->invalida = 1;
+        return;
+    }
+
+    int *registo = &u->riscadas[3 * --u->numRiscadas];
+    while (u->numUnioes > registo[1]) {
+        int b = u->unioes[--u->numUnioes];
+        u->tamanho[u->pai[b]] -= u->tamanho[b];
+        u->pai[b] = b;
+    }
+    u->componentes -= registo[2];
+    u->pai[k] = -1;
+}
+
+UniaoRiscadas* criarUniaoRiscadas(Jogo *jogo) {
+    if (!jogo) return NULL;
+
+    int total = jogo->linhas * jogo->colunas;
+    UniaoRiscadas *u = malloc(sizeof(UniaoRiscadas));
+    if (!u) return NULL;
+
+    u->pai = malloc((total + 1) * sizeof(int));
+    u->tamanho = malloc((total + 1) * sizeof(int));
+    u->unioes = malloc((total + 1) * sizeof(int));
+    u->riscadas = malloc(3 * total * sizeof(int));
+    if (!u->pai || !u->tamanho || !u->unioes || !u->riscadas) {
+        freeUniaoRiscadas(u);
+        return NULL;
+    }
+
+    UniaoRiscadas *anterior = jogo->uniao;
+    jogo->uniao = u;
+    reconstruirUniaoRiscadas(jogo);
+    jogo->uniao = anterior;
+
+    return u;
+}
+
+void freeUniaoRiscadas(UniaoRiscadas *uniao) {
+    if (uniao != NULL) {
+        free(uniao->pai);
+        free(uniao->tamanho);
+        free(uniao->unioes);
+        free(uniao->riscadas);
+        free(uniao);
+    }
+}
+
+// Riscar (linha, coluna) separaria as casas não riscadas em mais regiões?
+int riscarSepararia(Jogo *jogo, int linha, int coluna) {
+    if (!jogo || !jogo->uniao) return 0;
+    if (jogo->uniao->invalida) reconstruirUniaoRiscadas(jogo);
+    if (jogo->uniao->pai[linha * jogo->colunas + coluna] != -1) return 0;
+    return variacaoComponentes(jogo, linha, coluna) > 0;
+}
+
+// As casas não riscadas formam uma única região?
+int regiaoNaoRiscadaConexa(Jogo *jogo) {
+    if (!jogo || !jogo->uniao) return 0;
+    if (jogo->uniao->invalida) reconstruirUniaoRiscadas(jogo);
+    return jogo->uniao->componentes <= 1;
+}
+
+
+// Único ponto de alteração de uma casa: mantém as máscaras e a união de riscadas em sincronia
+void alterarCelula(Jogo *jogo, int linha, int coluna, char novo) {
+    char atual = jogo->tabuleiro[linha][coluna];
+    if (atual == novo) return;
+
+    if (jogo->mascaras) {
+        atualizarMascaras(jogo, linha, coluna, atual, 0);
+        atualizarMascaras(jogo, linha, coluna, novo, 1);
+        atualizarViolacoesVizinhanca(jogo, linha, coluna);
+    }
+    if (jogo->uniao) {
+        if (atual == '#') {
+            retirarRiscada(jogo, linha, coluna);
+        } else if (novo == '#' && !jogo->uniao->invalida) {
+            inserirRiscada(jogo, linha, coluna);
+        }
+    }
+    jogo->tabuleiro[linha][coluna] = novo;
+}
+
+
 
 // Funções etapa 2 ===================================================================================
 
-void registarMovimento(Jogo *jogo, int linha, int coluna, char estadoAnterior) {
-    if (!jogo) return;
+// Acrescenta ao histórico o movimento da casa de 'estadoAnterior' para 'estadoPosterior'. Os dois
+// estados ficam guardados logo, para que refazer e ir para um movimento nunca dependam do tabuleiro.
+// Devolve 0, ou -1 sem memória (o histórico fica como estava).
+static int acrescentarMovimento(Jogo *jogo, int linha, int coluna, char estadoAnterior, char estadoPosterior) {
+    HistoricoMovimentos *historico = &jogo->historico;
+    
+    if (historico->numMovimentos == historico->capacidade) {
+        int capacidade = historico->capacidade ? 2 * historico->capacidade : 64;
+        Movimento *movimentos = realloc(historico->movimentos, capacidade * sizeof(Movimento));
+        if (!movimentos) {
+            printf("Erro na alocação de memória para o histórico.\n");
+            return -1;
+        }
+        historico->movimentos = movimentos;
+        historico->capacidade = capacidade;
+    }
     
-    Movimento *novoMovimento = malloc(sizeof(Movimento));
-    if (!novoMovimento) {
-        printf("Erro na alocação de memória para o histórico.\n");
-        return;
+    // Um movimento novo apaga os desfeitos e os pontos de restauro que dependiam deles
+    if (historico->fim > historico->numMovimentos) {
+        historico->fim = historico->numMovimentos;
+        int pontosValidos = historico->numMovimentos / INTERVALO_PONTOS + 1;
+        if (historico->numPontos > pontosValidos) historico->numPontos = pontosValidos;
     }
     
+    Movimento *novoMovimento = &historico->movimentos[historico->numMovimentos];
     novoMovimento->linha = linha;
     novoMovimento->coluna = coluna;
     novoMovimento->estadoAnterior = estadoAnterior;
-    novoMovimento->proximo = NULL;
-    novoMovimento->grupoInterno = NULL; // Inicializa o campo de grupo interno
+    novoMovimento->estadoPosterior = estadoCasa(estadoPosterior);
     
-    if (jogo->agrupandoMovimentos) {
-        // Adiciona ao grupo de movimentos temporário
-        novoMovimento->proximo = jogo->grupoMovimentos;
-        jogo->grupoMovimentos = novoMovimento;
+    // Durante um agrupamento, o primeiro movimento marca o início do grupo
+    if (historico->inicioGrupo < 0) {
+        novoMovimento->grupo = MOVIMENTO_SIMPLES;
+    } else if (historico->numMovimentos == historico->inicioGrupo) {
+        novoMovimento->grupo = MOVIMENTO_INICIO_GRUPO;
     } else {
-        // Adiciona diretamente ao histórico
-        novoMovimento->proximo = jogo->historicoMovimentos;
-        jogo->historicoMovimentos = novoMovimento;
+        novoMovimento->grupo = MOVIMENTO_GRUPO;
     }
+    historico->numMovimentos++;
+    historico->fim = historico->numMovimentos;
+    atualizarPontos(jogo);
+    return 0;
+}
+
+// Regista um movimento já aplicado: o estado posterior é o atual da casa (o resolvedor regista a
+// solução com o tabuleiro já resolvido). Devolve 0, ou -1 se não foi registado.
+int registarMovimento(Jogo *jogo, int linha, int coluna, char estadoAnterior) {
+    if (!jogo) return -1;
+    return acrescentarMovimento(jogo, linha, coluna, estadoAnterior, jogo->tabuleiro[linha][coluna]);
+}
+
+// Regista o movimento que põe a casa com o valor 'novo' e aplica-o ao tabuleiro. Se não há memória
+// para o registar, a casa não é alterada, para o tabuleiro nunca ficar à frente do histórico.
+int aplicarMovimento(Jogo *jogo, int linha, int coluna, char novo) {
+    if (!jogo) return -1;
+    if (acrescentarMovimento(jogo, linha, coluna, jogo->tabuleiro[linha][coluna], novo) != 0) return -1;
+    if (jogo->tabuleiro[linha][coluna] != novo) alterarCelula(jogo, linha, coluna, novo);
+    return 0;
+}
+
+int numeroMovimentos(Jogo *jogo) {
+    return jogo ? jogo->historico.numMovimentos : 0;
+}
+
+// Movimento mais recente, ou NULL se o histórico está vazio
+Movimento* ultimoMovimento(Jogo *jogo) {
+    if (!jogo || jogo->historico.numMovimentos == 0) return NULL;
+    return &jogo->historico.movimentos[jogo->historico.numMovimentos - 1];
 }
 
 
 int desfazerMovimento(Jogo *jogo) {
-    if (!jogo || !jogo->historicoMovimentos) {
+    Movimento *ultimo = ultimoMovimento(jogo);
+    if (!ultimo) {
         printf("Não há movimento para desfazer.\n");
         return -1;
     }
-
-    Movimento *ultimoMovimento = jogo->historicoMovimentos;
+    HistoricoMovimentos *historico = &jogo->historico;
     
-    // Verifica se é um movimento de grupo (gerado pelo comando 'A')
-    if (ultimoMovimento->linha == -1 && ultimoMovimento->coluna == -1 && 
-        ultimoMovimento->estadoAnterior == 'A') {
-        
-        printf("A desfazer todos os movimentos da ajuda automática...\n");
+    // Verifica se é um movimento de grupo (gerado pelo comando 'A' ou pela reposição do tabuleiro inicial)
+    if (ultimo->grupo != MOVIMENTO_SIMPLES) {
+        printf("A desfazer todos os movimentos do grupo...\n");
         
-        // Remove o movimento de grupo do histórico principal
-        jogo->historicoMovimentos = ultimoMovimento->proximo;
-        
-        // Conta quantos movimentos serão desfeitos
+        // Desfaz do mais recente até ao início do grupo
         int contadorMovimentos = 0;
-        Movimento *temp = ultimoMovimento->grupoInterno;
-        while (temp != NULL) {
-            contadorMovimentos++;
-            temp = temp->proximo;
-        }
-        
-        // Desfaz todos os movimentos no grupo (que já estão na ordem correta)
-        Movimento *movimentoGrupo = ultimoMovimento->grupoInterno;
-        
-        while (movimentoGrupo != NULL) {
-            // Restaura o estado anterior da célula
-            jogo->tabuleiro[movimentoGrupo->linha][movimentoGrupo->coluna] = movimentoGrupo->estadoAnterior;
+        int fim = 0;
+        while (historico->numMovimentos > 0 && !fim) {
+            Movimento *movimento = &historico->movimentos[--historico->numMovimentos];
+            fim = movimento->grupo != MOVIMENTO_GRUPO;
+            alterarCelula(jogo, movimento->linha, movimento->coluna, movimento->estadoAnterior);
             
             printf("  Desfeito: (%c,%d) voltou para '%c'\n", 
-                   movimentoGrupo->coluna + 'a',
-                   movimentoGrupo->linha + 1,
-                   movimentoGrupo->estadoAnterior);
-            
-            // Passa para o próximo movimento do grupo
-            Movimento *tempMovimento = movimentoGrupo;
-            movimentoGrupo = movimentoGrupo->proximo;
-            free(tempMovimento);
+                   movimento->coluna + 'a',
+                   movimento->linha + 1,
+                   movimento->estadoAnterior);
+            contadorMovimentos++;
         }
         
-        free(ultimoMovimento); // Liberta o movimento de grupo
-        printf("Todos os %d movimentos da ajuda automática foram desfeitos.\n", contadorMovimentos);
-        printf("Tabuleiro restaurado ao estado anterior ao comando 'A'.\n");
+        printf("Todos os %d movimentos do grupo foram desfeitos.\n", contadorMovimentos);
+        printf("Tabuleiro restaurado ao estado anterior ao grupo.\n");
         return 0;
     }
     
     // Caso seja um movimento normal individual
-    char valorAtual = jogo->tabuleiro[ultimoMovimento->linha][ultimoMovimento->coluna];
-    jogo->tabuleiro[ultimoMovimento->linha][ultimoMovimento->coluna] = ultimoMovimento->estadoAnterior;
+    char valorAtual = jogo->tabuleiro[ultimo->linha][ultimo->coluna];
+    alterarCelula(jogo, ultimo->linha, ultimo->coluna, ultimo->estadoAnterior);
     
     printf("Movimento desfeito na posição (%c,%d): '%c' voltou para '%c'.\n",
-           ultimoMovimento->coluna + 'a',
-           ultimoMovimento->linha + 1,
+           ultimo->coluna + 'a',
+           ultimo->linha + 1,
            valorAtual,
-           ultimoMovimento->estadoAnterior);
+           ultimo->estadoAnterior);
 
     // Remove o movimento do histórico
-    jogo->historicoMovimentos = ultimoMovimento->proximo;
-    free(ultimoMovimento);
+    historico->numMovimentos--;
     return 0;
 }
 
-// Verifica se há duplicados de letras brancas (A-Z) numa linha
-int verificarDuplicadosLinha(Jogo *jogo, int linha) {
-    int contagem[26] = {0};
+// Repõe o tabuleiro inicial numa só passagem pelo vetor, sem desfazer o histórico movimento a
+// movimento. A reposição fica no histórico como um único grupo, que 'd' desfaz de uma vez.
+// Devolve o número de casas repostas, ou -1 se o jogo não tem tabuleiro inicial ou não há memória
+// para registar a reposição (as casas já repostas ficam no grupo).
+int reporTabuleiroInicial(Jogo *jogo) {
+    if (!jogo || !jogo->inicial) return -1;
 
-    for (int j = 0; j < jogo->colunas; j++) {
-        char c = toupper(jogo->tabuleiro[linha][j]);
-        if (c >= 'A' && c <= 'Z') {
-            if (contagem[c - 'A']++ > 0) {
-                return 1; // Duplicado encontrado
+    HistoricoMovimentos *historico = &jogo->historico;
+    int inicioGrupo = historico->numMovimentos;
+    historico->inicioGrupo = inicioGrupo;
+
+    for (int i = 0; i < jogo->linhas; i++) {
+        for (int j = 0; j < jogo->colunas; j++) {
+            char valor = jogo->inicial[INDICE_CELULA(jogo, i, j)];
+            if (jogo->tabuleiro[i][j] != valor && aplicarMovimento(jogo, i, j, valor) != 0) {
+                historico->inicioGrupo = -1;
+                return -1;
             }
         }
     }
-    return 0; // Sem duplicados
+
+    historico->inicioGrupo = -1;
+    return historico->numMovimentos - inicioGrupo;
 }
 
-// Verifica se há duplicados de letras brancas (A-Z) numa coluna
-int verificarDuplicadosColuna(Jogo *jogo, int coluna) {
-    int contagem[26] = {0};
+// Põe o tabuleiro no estado do ponto de restauro dado, alterando só as casas diferentes
+static void reporPonto(Jogo *jogo, int ponto) {
+    HistoricoMovimentos *historico = &jogo->historico;
+    const uint8_t *estados = historico->pontos + (size_t)ponto * ((jogo->linhas * jogo->colunas + 3) / 4);
 
     for (int i = 0; i < jogo->linhas; i++) {
-        char c = toupper(jogo->tabuleiro[i][coluna]);
-        if (c >= 'A' && c <= 'Z') {
-            if (contagem[c - 'A']++ > 0) {
-                return 1; // Duplicado encontrado
-            }
+        for (int j = 0; j < jogo->colunas; j++) {
+            char valor = valorCasa(jogo, INDICE_CELULA(jogo, i, j), estadoNoPonto(estados, i * jogo->colunas + j));
+            if (jogo->tabuleiro[i][j] != valor) alterarCelula(jogo, i, j, valor);
         }
     }
-    return 0; // Sem duplicados
+    historico->numMovimentos = ponto * INTERVALO_PONTOS;
 }
 
-// Devolve o número de adjacências de casas riscadas à posição (i,j)
-int contarRiscadasAdjacentes(Jogo *jogo, int i, int j) {
-    int count = 0;
-    int di[] = {0, 1};  // direita e abaixo
-    int dj[] = {1, 0};
+// Põe o tabuleiro no estado depois dos primeiros 'movimento' movimentos do histórico, de 0 (tabuleiro
+// inicial) até ao último movimento desfeito, sem escrever cada movimento. Quando o ponto de restauro
+// anterior ao alvo está mais perto do que o movimento atual, parte dele: nunca são refeitos mais de
+// INTERVALO_PONTOS movimentos. Devolve 0, ou -1 se o movimento está fora do histórico.
+int irParaMovimento(Jogo *jogo, int movimento) {
+    if (!jogo || !jogo->inicial) return -1;
 
-    for (int d = 0; d < 2; d++) {
-        int ni = i + di[d];
-        int nj = j + dj[d];
+    HistoricoMovimentos *historico = &jogo->historico;
+    if (movimento < 0 || movimento > historico->fim) {
+        printf("Movimento fora do histórico: %d (de 0 a %d).\n", movimento, historico->fim);
+        return -1;
+    }
+    atualizarPontos(jogo);     // Sem memória da última vez podem faltar pontos
 
-        if (ni >= 0 && ni < jogo->linhas && nj >= 0 && nj < jogo->colunas) {
-            if (jogo->tabuleiro[ni][nj] == '#') {
-                count++;
-            }
-        }
+    int ponto = movimento / INTERVALO_PONTOS;
+    if (ponto >= historico->numPontos) ponto = historico->numPontos - 1;
+    int distancia = abs(movimento - historico->numMovimentos);
+    if (ponto >= 0 && movimento - ponto * INTERVALO_PONTOS < distancia) reporPonto(jogo, ponto);
+
+    while (historico->numMovimentos < movimento) {
+        Movimento *m = &historico->movimentos[historico->numMovimentos++];
+        alterarCelula(jogo, m->linha, m->coluna, valorCasa(jogo, INDICE_CELULA(jogo, m->linha, m->coluna), m->estadoPosterior));
+    }
+    while (historico->numMovimentos > movimento) {
+        Movimento *m = &historico->movimentos[--historico->numMovimentos];
+        alterarCelula(jogo, m->linha, m->coluna, m->estadoAnterior);
+    }
+    return 0;
+}
+
+// Refaz o último movimento desfeito, ou o grupo inteiro se foi desfeito um grupo
+int refazerMovimento(Jogo *jogo) {
+    if (!jogo) return -1;
+
+    HistoricoMovimentos *historico = &jogo->historico;
+    if (historico->numMovimentos == historico->fim) {
+        printf("Não há movimento para refazer.\n");
+        return -1;
+    }
+
+    int alvo = historico->numMovimentos + 1;
+    if (historico->movimentos[historico->numMovimentos].grupo == MOVIMENTO_INICIO_GRUPO) {
+        while (alvo < historico->fim && historico->movimentos[alvo].grupo == MOVIMENTO_GRUPO) alvo++;
     }
 
-    return count;
+    int refeitos = alvo - historico->numMovimentos;
+    if (irParaMovimento(jogo, alvo) != 0) return -1;
+    if (refeitos == 1) {
+        Movimento *m = &historico->movimentos[alvo - 1];
+        printf("Movimento refeito na posição (%c,%d): '%c' passou a '%c'.\n",
+               m->coluna + 'a', m->linha + 1, m->estadoAnterior, jogo->tabuleiro[m->linha][m->coluna]);
+    } else {
+        printf("Grupo de %d movimentos refeito.\n", refeitos);
+    }
+    return 0;
+}
+
+// Verifica se há duplicados de letras (não riscadas) numa linha
+int verificarDuplicadosLinha(Jogo *jogo, int linha) {
+    return jogo->mascaras->excessoLinha[linha] > 0;
+}
+
+// Verifica se há duplicados de letras (não riscadas) numa coluna
+int verificarDuplicadosColuna(Jogo *jogo, int coluna) {
+    return jogo->mascaras->excessoColuna[coluna] > 0;
+}
+
+// Devolve o número de adjacências de casas riscadas à posição (i,j)
+int contarRiscadasAdjacentes(Jogo *jogo, int i, int j) {
+    int p = INDICE_CELULA(jogo, i, j);
+
+    // Direita e abaixo; as sentinelas da moldura nunca são '#'
+    return (jogo->celulas[p + 1] == '#') + (jogo->celulas[p + jogo->largura] == '#');
 }
 
 void aplicarAosVizinhos(Jogo *jogo, int i, int j, void (*acao)(Jogo *, int, int, void *), void *extra) {
-    int di[] = {-1, 1, 0, 0};
-    int dj[] = {0, 0, -1, 1};
+    int p = INDICE_CELULA(jogo, i, j);
 
     for (int d = 0; d < 4; d++) {
-        int ni = i + di[d];
-        int nj = j + dj[d];
+        int q = p + jogo->deslocamentos[d];
 
-        if (ni >= 0 && ni < jogo->linhas && nj >= 0 && nj < jogo->colunas) {
-            acao(jogo, ni, nj, extra);
+        if (jogo->celulas[q] != '\0') {
+            acao(jogo, q / jogo->largura - 1, q % jogo->largura, extra);
         }
     }
 }
 
-void verificarVizinhoBranco(Jogo *jogo, int i, int j, void *violacoesPtr) {
-    int *violacoes = (int *)violacoesPtr;
-    char c = jogo->tabuleiro[i][j];
-    if (c != '#' && !(c >= 'A' && c <= 'Z')) {
-        printf("Violação: Vizinho (%c%d) de casa riscada não é branco\n", 'a'+j, i+1);
-        (*violacoes)++;
-    }
-}
-
 void pintarVizinhoSeMinuscula(Jogo *jogo, int i, int j, void *alteracoesPtr) {
     int *alteracoes = (int *)alteracoesPtr;
     if (islower(jogo->tabuleiro[i][j])) {
-        char coord[3] = {'a'+j, '1'+i, '\0'};
-        if (pintarBranco(jogo, coord) == 0) {
-            printf("Ajuda: pintado %s (vizinho de riscada)\n", coord);
+        if (aplicarMovimento(jogo, i, j, jogo->tabuleiro[i][j] - 32) == 0) {
+            printf("Ajuda: pintado %c%c (vizinho de riscada)\n", 'a' + j, '1' + i);
             (*alteracoes)++;
         }
     }
@@ -442,47 +1024,149 @@ void pintarVizinhoSeMinuscula(Jogo *jogo, int i, int j, void *alteracoesPtr) {
 
 
 
-int verificarRestricoes(Jogo *jogo) {
-    if (!jogo) return -1;
-    
-    int violacoes = 0;
-    
-    // Verificação de símbolos únicos em linhas/colunas
-    for (int i = 0; i < jogo->linhas; i++) {
-    if (verificarDuplicadosLinha(jogo, i)) {
-        printf("Violação: Duplicados na linha %d\n", i+1);
-        violacoes++;
+static void acrescentarViolacao(ResultadoValidacao *resultado, TipoViolacao tipo, int linha, int coluna, int peso) {
+    resultado->porTipo[tipo] += peso;
+    resultado->total += peso;
+    if (resultado->lista && resultado->numListadas < resultado->capacidade) {
+        Violacao *v = &resultado->lista[resultado->numListadas++];
+        v->tipo = tipo;
+        v->linha = linha;
+        v->coluna = coluna;
     }
 }
-    
-    for (int j = 0; j < jogo->colunas; j++) {
-    if (verificarDuplicadosColuna(jogo, j)) {
-        printf("Violação: Duplicados na coluna %c\n", 'a'+j);
-        violacoes++;
+
+static void limparResultado(ResultadoValidacao *resultado) {
+    resultado->total = 0;
+    resultado->numListadas = 0;
+    for (int t = 0; t < NUM_TIPOS_VIOLACAO; t++) resultado->porTipo[t] = 0;
+}
+
+// Lista as violações de uma riscada pela mesma ordem da verificação completa
+static void listarViolacoesRiscada(Jogo *jogo, int i, int j, ResultadoValidacao *resultado) {
+    int p = INDICE_CELULA(jogo, i, j);
+    for (int d = 0; d < 4; d++) {
+        int q = p + jogo->deslocamentos[d];
+        char c = jogo->celulas[q];
+        if (c >= 'a' && c <= 'z') {
+            acrescentarViolacao(resultado, VIOLACAO_VIZINHO_NAO_BRANCO, q / jogo->largura - 1, q % jogo->largura, 1);
+        }
     }
+
+    int adjacentes = contarRiscadasAdjacentes(jogo, i, j);
+    if (adjacentes > 0) acrescentarViolacao(resultado, VIOLACAO_RISCADAS_ADJACENTES, i, j, adjacentes);
 }
 
+// Verifica as regras sem escrever nada, a partir do conjunto de violações em cache nas máscaras
+// (cada alteração só o refaz na linha, coluna e vizinhança da casa). Sem lista custa O(1) mais a
+// conectividade; com lista, O(linhas + violações). Se resultado->lista não for NULL, guarda até
+// resultado->capacidade violações (ver MAX_VIOLACOES); as contagens são sempre exatas.
+// Devolve o total de violações, ou -1 se o jogo for inválido.
+int validarTabuleiro(Jogo *jogo, ResultadoValidacao *resultado) {
+    if (!jogo || !resultado || !jogo->mascaras) return -1;
 
-    // Verifica a restrição: casas riscadas não podem ser adjacentes
-    for (int i = 0; i < jogo->linhas; i++) {
-        for (int j = 0; j < jogo->colunas; j++) {
-            if (jogo->tabuleiro[i][j] == '#') {
-                int adjacentes = contarRiscadasAdjacentes(jogo, i, j);
-                aplicarAosVizinhos(jogo, i, j, verificarVizinhoBranco, &violacoes);
-                if (adjacentes > 0) {
-                    printf("Violação: Casas riscadas adjacentes a (%c%d)\n", 'a'+j, i+1);
-                    violacoes += adjacentes;
-                }
+    MascarasTabuleiro *m = jogo->mascaras;
+    limparResultado(resultado);
+
+    if (resultado->lista) {
+        for (Mascara linhas = m->linhasDuplicadas; linhas; linhas &= linhas - 1) {
+            acrescentarViolacao(resultado, VIOLACAO_DUPLICADOS_LINHA, __builtin_ctzll(linhas), -1, 1);
+        }
+        for (Mascara colunas = m->colunasDuplicadas; colunas; colunas &= colunas - 1) {
+            acrescentarViolacao(resultado, VIOLACAO_DUPLICADOS_COLUNA, -1, __builtin_ctzll(colunas), 1);
+        }
+        for (int i = 0; i < jogo->linhas; i++) {
+            for (Mascara riscadas = m->violacoesLinha[i]; riscadas; riscadas &= riscadas - 1) {
+                listarViolacoesRiscada(jogo, i, __builtin_ctzll(riscadas), resultado);
             }
         }
+    } else {
+        // Só contagens: os contadores já têm os totais
+        resultado->porTipo[VIOLACAO_DUPLICADOS_LINHA] = __builtin_popcountll(m->linhasDuplicadas);
+        resultado->porTipo[VIOLACAO_DUPLICADOS_COLUNA] = __builtin_popcountll(m->colunasDuplicadas);
+        resultado->porTipo[VIOLACAO_VIZINHO_NAO_BRANCO] = m->paresRiscadaIndecisa;
+        resultado->porTipo[VIOLACAO_RISCADAS_ADJACENTES] = m->paresRiscados;
+        for (int t = 0; t < NUM_TIPOS_VIOLACAO; t++) resultado->total += resultado->porTipo[t];
     }
 
-    // Verificação adicional: conectividade das casas brancas
-    int conectividade = verificarConectividadeBrancas(jogo);
-    if (conectividade != 0) {
-        printf("Violação: As casas brancas não estão todas conectadas ortogonalmente.\n");
-        violacoes++;
-    } else {
+    // Conectividade das casas brancas
+    if (verificarConectividadeBrancas(jogo) != 0) acrescentarViolacao(resultado, VIOLACAO_BRANCAS_DESCONEXAS, -1, -1, 1);
+
+    return resultado->total;
+}
+
+// Mesma verificação percorrendo todas as linhas, colunas e riscadas, sem usar a cache
+int validarTabuleiroCompleto(Jogo *jogo, ResultadoValidacao *resultado) {
+    if (!jogo || !resultado || !jogo->mascaras) return -1;
+
+    limparResultado(resultado);
+    MascarasTabuleiro *m = jogo->mascaras;
+
+    // Símbolos únicos em linhas/colunas, contados nas máscaras de letras
+    for (int i = 0; i < jogo->linhas; i++) {
+        int repetida = 0;
+        for (int l = 0; l < NUM_LETRAS && !repetida; l++) repetida = __builtin_popcountll(m->letraLinha[l * jogo->linhas + i]) > 1;
+        if (repetida) acrescentarViolacao(resultado, VIOLACAO_DUPLICADOS_LINHA, i, -1, 1);
+    }
+    for (int j = 0; j < jogo->colunas; j++) {
+        int repetida = 0;
+        for (int l = 0; l < NUM_LETRAS && !repetida; l++) repetida = __builtin_popcountll(m->letraColuna[l * jogo->colunas + j]) > 1;
+        if (repetida) acrescentarViolacao(resultado, VIOLACAO_DUPLICADOS_COLUNA, -1, j, 1);
+    }
+
+    // Vizinhos de riscadas têm de ser brancos e as riscadas não podem ser adjacentes
+    for (int i = 0; i < jogo->linhas; i++) {
+        Mascara riscadas = jogo->mascaras->riscadasLinha[i];
+        while (riscadas) {
+            int j = __builtin_ctzll(riscadas);
+            riscadas &= riscadas - 1;
+            listarViolacoesRiscada(jogo, i, j, resultado);
+        }
+    }
+
+    // Conectividade das casas brancas
+    if (verificarConectividadeBrancas(jogo) != 0) acrescentarViolacao(resultado, VIOLACAO_BRANCAS_DESCONEXAS, -1, -1, 1);
+
+    return resultado->total;
+}
+
+// Formata o resultado de validarTabuleiro para o comando 'v'
+int verificarRestricoes(Jogo *jogo) {
+    if (!jogo) return -1;
+
+    ResultadoValidacao resultado;
+    resultado.capacidade = MAX_VIOLACOES(jogo);
+    resultado.lista = malloc(resultado.capacidade * sizeof(Violacao));
+    if (!resultado.lista) {
+        printf("Erro na alocação de memória para a verificação.\n");
+        return -1;
+    }
+    int violacoes = validarTabuleiro(jogo, &resultado);
+
+    for (int k = 0; k < resultado.numListadas; k++) {
+        Violacao *v = &resultado.lista[k];
+        switch (v->tipo) {
+            case VIOLACAO_DUPLICADOS_LINHA:
+                printf("Violação: Duplicados na linha %d\n", v->linha + 1);
+                break;
+            case VIOLACAO_DUPLICADOS_COLUNA:
+                printf("Violação: Duplicados na coluna %c\n", 'a' + v->coluna);
+                break;
+            case VIOLACAO_VIZINHO_NAO_BRANCO:
+                printf("Violação: Vizinho (%c%d) de casa riscada não é branco\n", 'a' + v->coluna, v->linha + 1);
+                break;
+            case VIOLACAO_RISCADAS_ADJACENTES:
+                printf("Violação: Casas riscadas adjacentes a (%c%d)\n", 'a' + v->coluna, v->linha + 1);
+                break;
+            case VIOLACAO_BRANCAS_DESCONEXAS:
+                printf("Violação: As casas brancas não estão todas conectadas ortogonalmente.\n");
+                break;
+            default:
+                break;
+        }
+    }
+    free(resultado.lista);
+
+    if (resultado.porTipo[VIOLACAO_BRANCAS_DESCONEXAS] == 0) {
         printf("Todas as casas brancas estão conectadas.\n");
     }
 
@@ -492,23 +1176,35 @@ int verificarRestricoes(Jogo *jogo) {
         printf("Total de %d violações encontradas.\n", violacoes);
         printf("Use o comando 'd' se pretender desfazer o último movimento.\n");
     }
-    
 
     return violacoes ? -1 : 0;
 }
 
 
-void freeHistoricoMovimentos(Movimento *historico) {
-    while (historico != NULL) {
-        Movimento *temp = historico;
-        
-        // Se for um movimento de grupo, liberta os movimentos internos primeiro
-        if (temp->linha == -1 && temp->coluna == -1 && temp->estadoAnterior == 'G') {
-            freeHistoricoMovimentos(temp->grupoInterno);
-        }
-        
-        historico = historico->proximo;
-        free(temp);
+// Copia o histórico (com as marcas de grupo); devolve -1 se faltar memória
+int copiarHistoricoMovimentos(HistoricoMovimentos *destino, const HistoricoMovimentos *origem) {
+    Movimento *movimentos = NULL;
+    if (origem->numMovimentos > 0) {
+        movimentos = malloc(origem->numMovimentos * sizeof(Movimento));
+        if (!movimentos) return -1;
+        memcpy(movimentos, origem->movimentos, origem->numMovimentos * sizeof(Movimento));
+    }
+    
+    free(destino->movimentos);
+    destino->movimentos = movimentos;
+    destino->numMovimentos = origem->numMovimentos;
+    destino->capacidade = origem->numMovimentos;
+    destino->inicioGrupo = origem->inicioGrupo;
+    destino->fim = origem->numMovimentos;
+    destino->numPontos = 0;     // Os pontos são refeitos com o jogo de destino
+    return 0;
+}
+
+void freeHistoricoMovimentos(HistoricoMovimentos *historico) {
+    if (historico != NULL) {
+        free(historico->movimentos);
+        free(historico->pontos);
+        *historico = (HistoricoMovimentos){ .inicioGrupo = -1 };
     }
 }
 
@@ -518,9 +1214,10 @@ void freeHistoricoMovimentos(Movimento *historico) {
 
 // DFS fora da função principal
 void dfs(Jogo *jogo, int **visitado, int *visitadas, int linha, int coluna) {
-    if (linha < 0 || linha >= jogo->linhas || coluna < 0 || coluna >= jogo->colunas) return;
+    // Fora do tabuleiro cai-se numa sentinela, que não é branca
+    char c = jogo->celulas[INDICE_CELULA(jogo, linha, coluna)];
+    if (!(c >= 'A' && c <= 'Z')) return;
     if (visitado[linha][coluna]) return;
-    if (!(jogo->tabuleiro[linha][coluna] >= 'A' && jogo->tabuleiro[linha][coluna] <= 'Z')) return;
 
     // Marca como visitado e incrementa o contador de casas brancas conectadas
     visitado[linha][coluna] = 1;
@@ -533,163 +1230,308 @@ void dfs(Jogo *jogo, int **visitado, int *visitadas, int linha, int coluna) {
     dfs(jogo, visitado, visitadas, linha, coluna + 1); // direita
 }
 
+// Devolve a área de trabalho do jogo, criando-a no primeiro uso
+AreaTrabalho* obterAreaTrabalho(Jogo *jogo) {
+    if (!jogo) return NULL;
+    if (jogo->trabalho) return jogo->trabalho;
+
+    // Indexada como o vetor de casas, moldura incluída
+    int total = (jogo->linhas + 2) * jogo->largura;
+    AreaTrabalho *t = malloc(sizeof(AreaTrabalho));
+    if (!t) return NULL;
+
+    t->marca = calloc(total, sizeof(unsigned int));
+    t->pilha = malloc(4 * total * sizeof(int));
+    t->direcao = malloc(2 * total * sizeof(char));
+    if (!t->marca || !t->pilha || !t->direcao) {
+        free(t->marca);
+        free(t->pilha);
+        free(t->direcao);
+        free(t);
+        return NULL;
+    }
+    t->descoberta = t->pilha + total;
+    t->baixo = t->descoberta + total;
+    t->pai = t->baixo + total;
+    t->articulacao = t->direcao + total;
+    t->epoca = 0;
+    t->chamadasConectividade = 0;
+
+    jogo->trabalho = t;
+    return t;
+}
+
+void freeAreaTrabalho(AreaTrabalho *trabalho) {
+    if (trabalho != NULL) {
+        free(trabalho->marca);
+        free(trabalho->pilha);
+        free(trabalho->direcao);
+        free(trabalho);
+    }
+}
+
+// Devolve a arena do jogo, criando-a no primeiro uso. Cada utilizador marca a arena antes de
+// reservar e volta à marca no fim, pelo que os blocos são reaproveitados de chamada para chamada.
+Arena* obterArena(Jogo *jogo) {
+    if (!jogo) return NULL;
+    if (!jogo->arena) jogo->arena = criarArena(TAMANHO_BLOCO_ARENA);
+    return jogo->arena;
+}
+
+// Começa uma nova travessia: todas as marcas anteriores deixam de contar
+static unsigned int novaEpoca(Jogo *jogo, AreaTrabalho *t) {
+    if (++t->epoca == 0) {
+        memset(t->marca, 0, (jogo->linhas + 2) * jogo->largura * sizeof(unsigned int));
+        t->epoca = 1;
+    }
+    return t->epoca;
+}
+
+// Verifica se as casas brancas estão ligadas ortogonalmente entre si, com uma travessia
+// iterativa sobre a área de trabalho do jogo (sem alocações depois da primeira chamada)
 int verificarConectividadeBrancas(Jogo *jogo) {
     if (!jogo) return -1;
 
-    int totalBrancas = 0;
-    int visitadas = 0;
-
-    int **visitado = malloc(jogo->linhas * sizeof(int *));
-    if (!visitado) {
-        printf("Erro ao alocar matriz de visitados.\n");
+    AreaTrabalho *t = obterAreaTrabalho(jogo);
+    if (!t) {
+        printf("Erro ao alocar a área de trabalho.\n");
         return -1;
     }
-    for (int i = 0; i < jogo->linhas; i++) {
-        visitado[i] = calloc(jogo->colunas, sizeof(int));
-        if (!visitado[i]) {
-            for (int j = 0; j < i; j++) free(visitado[j]);
-            free(visitado);
-            printf("Erro ao alocar linha da matriz de visitados.\n");
-            return -1;
-        }
-    }
+    t->chamadasConectividade++;
 
-    int inicioLinha = -1, inicioColuna = -1;
+    // Sem casas por decidir, as brancas são exatamente as não riscadas: basta a união de riscadas
+    int totalBrancas = 0, inicio = -1, indecisas = 0;
     for (int i = 0; i < jogo->linhas; i++) {
-        for (int j = 0; j < jogo->colunas; j++) {
-            if (jogo->tabuleiro[i][j] >= 'A' && jogo->tabuleiro[i][j] <= 'Z') {
-                totalBrancas++;
-                if (inicioLinha == -1) {
-                    inicioLinha = i;
-                    inicioColuna = j;
-                }
+        Mascara brancas = jogo->mascaras->brancasLinha[i];
+        if (brancas && inicio == -1) inicio = INDICE_CELULA(jogo, i, __builtin_ctzll(brancas));
+        totalBrancas += __builtin_popcountll(brancas);
+        indecisas |= jogo->mascaras->indecisasLinha[i] != 0;
+    }
+    if (!indecisas) return regiaoNaoRiscadaConexa(jogo) ? 0 : -1;
+    if (totalBrancas == 0) return 0;
+
+    unsigned int epoca = novaEpoca(jogo, t);
+
+    int topo = 0, visitadas = 1;
+    t->marca[inicio] = epoca;
+    t->pilha[topo++] = inicio;
+
+    while (topo > 0) {
+        int v = t->pilha[--topo];
+        for (int d = 0; d < 4; d++) {
+            int w = v + jogo->deslocamentos[d];
+            char c = jogo->celulas[w];
+            if (t->marca[w] != epoca && c >= 'A' && c <= 'Z') {
+                t->marca[w] = epoca;
+                t->pilha[topo++] = w;
+                visitadas++;
             }
         }
     }
 
-    if (totalBrancas == 0) {
-        //printf("Não há casas brancas no tabuleiro.\n");
-        for (int i = 0; i < jogo->linhas; i++) free(visitado[i]);
-        free(visitado);
-        return 0;
+    return visitadas == totalBrancas ? 0 : -1;
+}
+
+
+// Pontos de articulação do grafo das casas não riscadas (ligações ortogonais), numa única
+// passagem de Tarjan iterativa. Numa solução as casas não riscadas formam uma só região e uma
+// região separada só poderia ser riscada por inteiro, deixando riscadas adjacentes; por isso
+// todo o ponto de articulação tem de ficar branco.
+// Preenche articulacao[i * colunas + j] (pode ser a da área de trabalho) e devolve o número
+// de pontos de articulação, ou -1 se o grafo já está desconexo (ou não há memória).
+int calcularPontosArticulacao(Jogo *jogo, char *articulacao) {
+    if (!jogo || !articulacao) return -1;
+
+    AreaTrabalho *t = obterAreaTrabalho(jogo);
+    if (!t) {
+        printf("Erro ao alocar a área de trabalho.\n");
+        return -1;
     }
 
-    // Chama a função DFS com apontador para visitadas
-    dfs(jogo, visitado, &visitadas, inicioLinha, inicioColuna);
+    int colunas = jogo->colunas, largura = jogo->largura;
+    int *descoberta = t->descoberta, *baixo = t->baixo, *pai = t->pai, *pilha = t->pilha;
+    char *direcao = t->direcao;
+    char *celulas = jogo->celulas;
+    unsigned int epoca = novaEpoca(jogo, t);
 
-    for (int i = 0; i < jogo->linhas; i++) free(visitado[i]);
-    free(visitado);
+    int inicio = -1, naoRiscadas = 0;
+    for (int i = 0; i < jogo->linhas; i++) {
+        for (int j = 0; j < colunas; j++) {
+            articulacao[i * colunas + j] = 0;
+            if (jogo->tabuleiro[i][j] != '#') {
+                naoRiscadas++;
+                if (inicio == -1) inicio = INDICE_CELULA(jogo, i, j);
+            }
+        }
+    }
 
-    if (visitadas == totalBrancas) {
-        //printf("Todas as casas brancas estão conectadas.\n");
-        return 0;
+    int tempo = 0, topo = 0, filhosRaiz = 0, visitadas = 0;
+    if (inicio != -1) {
+        t->marca[inicio] = epoca;
+        descoberta[inicio] = baixo[inicio] = ++tempo;
+        direcao[inicio] = 0;
+        pai[inicio] = -1;
+        pilha[topo++] = inicio;
+        visitadas = 1;
+    }
+
+    while (topo > 0) {
+        int v = pilha[topo - 1];
+
+        if (direcao[v] < 4) {
+            int w = v + jogo->deslocamentos[(int)direcao[v]++];
+            if (celulas[w] == '#' || celulas[w] == '\0') continue;
+
+            if (t->marca[w] != epoca) {
+                t->marca[w] = epoca;
+                pai[w] = v;
+                descoberta[w] = baixo[w] = ++tempo;
+                direcao[w] = 0;
+                pilha[topo++] = w;
+                visitadas++;
+                if (v == inicio) filhosRaiz++;
+            } else if (w != pai[v] && descoberta[w] < baixo[v]) {
+                baixo[v] = descoberta[w];
+            }
+        } else {
+            topo--;
+            int p = pai[v];
+            if (p >= 0) {
+                if (baixo[v] < baixo[p]) baixo[p] = baixo[v];
+                if (p != inicio && baixo[v] >= descoberta[p]) {
+                    articulacao[(p / largura - 1) * colunas + p % largura] = 1;
+                }
+            }
+        }
     }
 
-    return -1;
-}
+    if (visitadas != naoRiscadas) return -1;
+    if (filhosRaiz >= 2) articulacao[(inicio / largura - 1) * colunas + inicio % largura] = 1;
 
+    int pontos = 0;
+    for (int k = 0; k < jogo->linhas * colunas; k++) pontos += articulacao[k];
+    return pontos;
+}
 
 
 // Funções etapa 4 ==========================================================================================
 
 void iniciarAgrupamentoMovimentos(Jogo *jogo) {
     if (!jogo) return;
-    jogo->agrupandoMovimentos = 1;
-    jogo->grupoMovimentos = NULL;
+    jogo->historico.inicioGrupo = jogo->historico.numMovimentos;
 }
 
 int simulaRiscarEVerificaConectividade(Jogo *jogo, int i, int j) {
     char original = jogo->tabuleiro[i][j];
-    jogo->tabuleiro[i][j] = '#';
+    alterarCelula(jogo, i, j, '#');
     int resultado = verificarConectividadeBrancas(jogo);
-    jogo->tabuleiro[i][j] = original;
+    alterarCelula(jogo, i, j, original);
     return resultado;
 }
 
+// Máscara das casas no mesmo estado (branca, por decidir ou riscada) que 'celula'
+static Mascara mascaraEstadoLinha(Jogo *jogo, int linha, char celula) {
+    MascarasTabuleiro *m = jogo->mascaras;
+    if (celula == '#') return m->riscadasLinha[linha];
+    int l = indiceLetra(celula);
+    if (l < 0) return 0;
+    Mascara estado = isupper(celula) ? m->brancasLinha[linha] : m->indecisasLinha[linha];
+    return estado & m->letraLinha[l * jogo->linhas + linha];
+}
+
+static Mascara mascaraEstadoColuna(Jogo *jogo, int coluna, char celula) {
+    MascarasTabuleiro *m = jogo->mascaras;
+    if (celula == '#') return m->riscadasColuna[coluna];
+    int l = indiceLetra(celula);
+    if (l < 0) return 0;
+    Mascara estado = isupper(celula) ? m->brancasColuna[coluna] : m->indecisasColuna[coluna];
+    return estado & m->letraColuna[l * jogo->colunas + coluna];
+}
+
 int existeDuplicadoNaLinha(Jogo *jogo, int linha, int colunaIgnorar, char celula) {
-    for (int j = 0; j < jogo->colunas; j++) {
-        if (j != colunaIgnorar && jogo->tabuleiro[linha][j] == celula)
-            return 1;
-    }
-    return 0;
+    Mascara ignorar = colunaIgnorar >= 0 && colunaIgnorar < jogo->colunas ? (Mascara)1 << colunaIgnorar : 0;
+    return (mascaraEstadoLinha(jogo, linha, celula) & ~ignorar) != 0;
 }
 
 int existeDuplicadoNaColuna(Jogo *jogo, int coluna, int linhaIgnorar, char celula) {
-    for (int i = 0; i < jogo->linhas; i++) {
-        if (i != linhaIgnorar && jogo->tabuleiro[i][coluna] == celula)
-            return 1;
-    }
-    return 0;
+    Mascara ignorar = linhaIgnorar >= 0 && linhaIgnorar < jogo->linhas ? (Mascara)1 << linhaIgnorar : 0;
+    return (mascaraEstadoColuna(jogo, coluna, celula) & ~ignorar) != 0;
 }
 
 void riscarDuplicadosLinha(Jogo *jogo, int linha, char letra, int *alteracoes) {
-    for (int j = 0; j < jogo->colunas; j++) {
-        if (tolower(jogo->tabuleiro[linha][j]) == letra && islower(jogo->tabuleiro[linha][j])) {
-            char coord[3] = {'a'+j, '1'+linha, '\0'};
-            if (riscar(jogo, coord) == 0) {
-                printf("Ajuda: riscado %s (duplicado na linha)\n", coord);
-                (*alteracoes)++;
-            }
+    Mascara alvo = islower(letra) ? mascaraEstadoLinha(jogo, linha, letra) : 0;
+    while (alvo) {
+        int j = __builtin_ctzll(alvo);
+        alvo &= alvo - 1;
+        if (aplicarMovimento(jogo, linha, j, '#') == 0) {
+            printf("Ajuda: riscado %c%c (duplicado na linha)\n", 'a' + j, '1' + linha);
+            (*alteracoes)++;
         }
     }
 }
 
 void riscarDuplicadosColuna(Jogo *jogo, int coluna, char letra, int *alteracoes) {
-    for (int i = 0; i < jogo->linhas; i++) {
-        if (tolower(jogo->tabuleiro[i][coluna]) == letra && islower(jogo->tabuleiro[i][coluna])) {
-            char coord[3] = {'a'+coluna, '1'+i, '\0'};
-            if (riscar(jogo, coord) == 0) {
-                printf("Ajuda: riscado %s (duplicado na coluna)\n", coord);
-                (*alteracoes)++;
-            }
+    Mascara alvo = islower(letra) ? mascaraEstadoColuna(jogo, coluna, letra) : 0;
+    while (alvo) {
+        int i = __builtin_ctzll(alvo);
+        alvo &= alvo - 1;
+        if (aplicarMovimento(jogo, i, coluna, '#') == 0) {
+            printf("Ajuda: riscado %c%c (duplicado na coluna)\n", 'a' + coluna, '1' + i);
+            (*alteracoes)++;
         }
     }
 }
 
-
 void finalizarAgrupamentoMovimentos(Jogo *jogo) {
-    if (!jogo || !jogo->agrupandoMovimentos) return;
+    if (!jogo || jogo->historico.inicioGrupo < 0) return;
+    
+    // Os movimentos do grupo já estão no histórico, marcados: basta contá-los
+    int numMovimentos = jogo->historico.numMovimentos - jogo->historico.inicioGrupo;
+    jogo->historico.inicioGrupo = -1;
     
     // Se não houver movimentos no grupo, apenas desativa o agrupamento
-    if (!jogo->grupoMovimentos) {
-        jogo->agrupandoMovimentos = 0;
+    if (numMovimentos == 0) {
         printf("Agrupamento finalizado (nenhum movimento realizado).\n");
         return;
     }
     
-    // Criar um movimento especial para representar o grupo
-    Movimento *movimentoGrupo = malloc(sizeof(Movimento));
-    if (!movimentoGrupo) {
-        printf("Erro na alocação de memória para agrupamento.\n");
-        return;
-    }
-    
-    movimentoGrupo->linha = -1;  // Valor especial para indicar que é um grupo
-    movimentoGrupo->coluna = -1;
-    movimentoGrupo->estadoAnterior = 'A';  // 'A' de ajuda automática
-    movimentoGrupo->proximo = jogo->historicoMovimentos;
-    movimentoGrupo->grupoInterno = NULL; // Inicializar como NULL
-    movimentoGrupo->grupoInterno = jogo->grupoMovimentos;
-    
-    // Adiciona o movimento especial ao histórico
-    jogo->historicoMovimentos = movimentoGrupo;
-    
-    // Conta os movimentos para feedback
-    int numMovimentos = 0;
-    Movimento *temp = jogo->grupoMovimentos;
-    while (temp != NULL) {
-        numMovimentos++;
-        temp = temp->proximo;
-    }
-    
     printf("Agrupamento finalizado: %d movimentos registados como grupo.\n", numMovimentos);
     printf("Use 'd' para desfazer todos os movimentos deste grupo de uma vez.\n");
-    
-    // Reinicializa o estado de agrupamento
-    jogo->agrupandoMovimentos = 0;
-    jogo->grupoMovimentos = NULL;
 }
 
+// Filas de trabalho da ajuda automática (índices i * colunas + j). Cada casa entra no máximo
+// uma vez: ou já estava decidida no início, ou é decidida aqui uma única vez.
+typedef struct {
+    int *brancas;       // Brancas por examinar pela regra 1
+    int numBrancas;
+    int *riscadas;      // Riscadas por examinar pela regra 2
+    int numRiscadas;
+    int semMemoria;     // Uma casa ficou por decidir por falta de memória para o histórico
+} FilaAjuda;
+
+static void decidirCasaAjuda(Jogo *jogo, FilaAjuda *fila, int linha, int coluna, char novo) {
+    int falhou = aplicarMovimento(jogo, linha, coluna, novo) != 0;
+
+    if (!fila) return;
+    if (falhou) {
+        fila->semMemoria = 1;
+        return;
+    }
+    if (!fila->brancas) return;     // Sem filas: só se quer saber se alguma casa falhou ('ajudar')
+    int k = linha * jogo->colunas + coluna;
+    if (novo == '#') fila->riscadas[fila->numRiscadas++] = k;
+    else fila->brancas[fila->numBrancas++] = k;
+}
+
+// Casa deduzida por uma regra da tabela (contexto: a fila da ajuda automática, ou NULL)
+static void decidirCasaRegra(Jogo *jogo, int linha, int coluna, char novo, IdRegra regra, void *contexto) {
+    printf("Ajuda: %s %c%c (%s)\n", novo == '#' ? "riscar" : "pintar", 'a' + coluna, '1' + linha,
+           REGRAS_DEDUCAO[regra].descricao);
+    decidirCasaAjuda(jogo, contexto, linha, coluna, novo);
+}
+
+// Aplica a primeira regra que resulte. Devolve o número de casas alteradas, ou -1 se um movimento
+// não pôde ser registado por falta de memória (essa casa fica como estava).
 int ajudar(Jogo *jogo) {
     if (!jogo) return -1;
     
@@ -703,23 +1545,23 @@ int ajudar(Jogo *jogo) {
                 char letraMinuscula = atual + 32; // Converte para minúscula correspondente
                 
                 // Verifica linha - riscar todas as letras minúsculas iguais na mesma linha
-                for (int k = 0; k < jogo->colunas; k++) {
-                    if (k != j && jogo->tabuleiro[i][k] == letraMinuscula) {
-                        char coord[3] = { 'a' + k, '1' + i, '\0' };
-                        printf("Ajuda: riscar %s (igual a branca %c na linha %d)\n", coord, atual, i+1);
-                        riscar(jogo, coord);
-                        alteracoesFeitas++;
-                    }
+                Mascara alvo = mascaraEstadoLinha(jogo, i, letraMinuscula);
+                while (alvo) {
+                    int k = __builtin_ctzll(alvo);
+                    alvo &= alvo - 1;
+                    if (aplicarMovimento(jogo, i, k, '#') != 0) return -1;
+                    printf("Ajuda: riscar %c%c (igual a branca %c na linha %d)\n", 'a' + k, '1' + i, atual, i+1);
+                    alteracoesFeitas++;
                 }
                 
                 // Verifica coluna - riscar todas as letras minúsculas iguais na mesma coluna
-                for (int k = 0; k < jogo->linhas; k++) {
-                    if (k != i && jogo->tabuleiro[k][j] == letraMinuscula) {
-                        char coord[3] = { 'a' + j, '1' + k, '\0' };
-                        printf("Ajuda: riscar %s (igual a branca %c na coluna %c)\n", coord, atual, 'a'+j);
-                        riscar(jogo, coord);
-                        alteracoesFeitas++;
-                    }
+                alvo = mascaraEstadoColuna(jogo, j, letraMinuscula);
+                while (alvo) {
+                    int k = __builtin_ctzll(alvo);
+                    alvo &= alvo - 1;
+                    if (aplicarMovimento(jogo, k, j, '#') != 0) return -1;
+                    printf("Ajuda: riscar %c%c (igual a branca %c na coluna %c)\n", 'a' + j, '1' + k, atual, 'a'+j);
+                    alteracoesFeitas++;
                 }
             }
         }
@@ -734,18 +1576,15 @@ int ajudar(Jogo *jogo) {
     for (int i = 0; i < jogo->linhas; i++) {
         for (int j = 0; j < jogo->colunas; j++) {
             if (jogo->tabuleiro[i][j] == '#') {
-                int di[] = {-1, 1, 0, 0};
-                int dj[] = {0, 0, -1, 1};
+                int p = INDICE_CELULA(jogo, i, j);
                 for (int d = 0; d < 4; d++) {
-                    int ni = i + di[d], nj = j + dj[d];
-                    if (ni >= 0 && ni < jogo->linhas && nj >= 0 && nj < jogo->colunas) {
-                        char viz = jogo->tabuleiro[ni][nj];
-                        if (viz >= 'a' && viz <= 'z') {
-                            char coord[3] = { 'a' + nj, '1' + ni, '\0' };
-                            printf("Ajuda: pintar %s (vizinho de casa riscada em %c%d)\n", coord, 'a'+j, i+1);
-                            pintarBranco(jogo, coord);
-                            alteracoesFeitas++;
-                        }
+                    int q = p + jogo->deslocamentos[d];
+                    char viz = jogo->celulas[q];
+                    if (viz >= 'a' && viz <= 'z') {
+                        int ni = q / jogo->largura - 1, nj = q % jogo->largura;
+                        if (aplicarMovimento(jogo, ni, nj, viz - 32) != 0) return -1;
+                        printf("Ajuda: pintar %c%c (vizinho de casa riscada em %c%d)\n", 'a' + nj, '1' + ni, 'a'+j, i+1);
+                        alteracoesFeitas++;
                     }
                 }
             }
@@ -757,36 +1596,162 @@ int ajudar(Jogo *jogo) {
         return alteracoesFeitas;
     }
 
-    // 3. Regra: pintar de branco casas que isolariam brancas se fossem riscadas
-    for (int i = 0; i < jogo->linhas; i++) {
-        for (int j = 0; j < jogo->colunas; j++) {
-            char c = jogo->tabuleiro[i][j];
-            if (c >= 'a' && c <= 'z') {
-                // Simula riscar esta casa
-                char original = jogo->tabuleiro[i][j];
-                jogo->tabuleiro[i][j] = '#';
-                int resultado = verificarConectividadeBrancas(jogo);
-                jogo->tabuleiro[i][j] = original;
-
-                if (resultado != 0) {
-                    char coord[3] = { 'a' + j, '1' + i, '\0' };
-                    printf("Ajuda: pintar de branco %s (evita isolamento)\n", coord);
-                    pintarBranco(jogo, coord);
+    // 3. Regra: pintar de branco casas que isolariam outras se fossem riscadas
+    //    (todos os pontos de articulação por decidir, obtidos numa só passagem)
+    AreaTrabalho *trabalho = obterAreaTrabalho(jogo);
+    char *articulacao = trabalho ? trabalho->articulacao : NULL;
+    if (articulacao && calcularPontosArticulacao(jogo, articulacao) > 0) {
+        for (int i = 0; i < jogo->linhas; i++) {
+            for (int j = 0; j < jogo->colunas; j++) {
+                char c = jogo->tabuleiro[i][j];
+                if (articulacao[i * jogo->colunas + j] && c >= 'a' && c <= 'z') {
+                    if (aplicarMovimento(jogo, i, j, c - 32) != 0) return -1;
+                    printf("Ajuda: pintar de branco %c%c (evita isolamento)\n", 'a' + j, '1' + i);
                     alteracoesFeitas++;
-                    // Retorna imediatamente após encontrar uma casa que evita isolamento
-                    return alteracoesFeitas;
                 }
             }
         }
     }
-    
+
+    if (alteracoesFeitas > 0) {
+        return alteracoesFeitas;
+    }
+
+    // 4. Regras da tabela de deduções (sanduíche, pares adjacentes, cantos, letras únicas)
+    FilaAjuda falhas = {0};
+    alteracoesFeitas = aplicarRegrasDeducao(jogo, 1, decidirCasaRegra, &falhas, NULL);
+    if (falhas.semMemoria) return -1;
+    if (alteracoesFeitas < 0) alteracoesFeitas = 0;
+
     if (alteracoesFeitas == 0) {
         printf("Nenhuma jogada inferida disponível no momento.\n");
     }
-    
+
     return alteracoesFeitas;
 }
 
+// Casa fixada pela sondagem: o outro valor leva a uma contradição
+static void fixarCasaSondagem(Jogo *jogo, int linha, int coluna, char novo, void *contexto) {
+    printf("Ajuda: %s %c%c (%s leva a uma contradição)\n", novo == '#' ? "riscar" : "pintar",
+           'a' + coluna, '1' + linha, novo == '#' ? "pintá-la" : "riscá-la");
+    decidirCasaAjuda(jogo, contexto, linha, coluna, novo);
+}
+
+// Aplica as regras de 'ajudar' até não haver mais jogadas, mas só a partir das casas alteradas:
+// a regra 1 examina cada branca uma vez e a regra 2 cada riscada uma vez. A prioridade entre
+// regras é a mesma de chamar 'ajudar' repetidamente (1 antes de 2, a 3 e a tabela de regras só
+// com as filas vazias), pelo que o tabuleiro final é igual. disparos[r], se não for NULL, conta
+// as casas decididas por cada regra da tabela. Quando nenhuma regra resulta, a sondagem (com o
+// orçamento configurado para toda a chamada) tenta ainda fixar casas por contradição.
+// Devolve o número de casas alteradas.
+int ajudaAutomatica(Jogo *jogo, int *rondas, long *disparos) {
+    if (!jogo) return -1;
+
+    int total = jogo->linhas * jogo->colunas;
+    Arena *arena = obterArena(jogo);
+    MarcaArena marca = arena ? marcarArena(arena) : (MarcaArena){0};
+    FilaAjuda fila = { .brancas = reservarArena(arena, 2 * total * sizeof(int)) };
+    if (!fila.brancas) {
+        printf("Erro na alocação de memória para a ajuda automática.\n");
+        return -1;
+    }
+    fila.riscadas = fila.brancas + total;
+
+    for (int i = 0; i < jogo->linhas; i++) {
+        for (int j = 0; j < jogo->colunas; j++) {
+            char c = jogo->tabuleiro[i][j];
+            if (c == '#') fila.riscadas[fila.numRiscadas++] = i * jogo->colunas + j;
+            else if (c >= 'A' && c <= 'Z') fila.brancas[fila.numBrancas++] = i * jogo->colunas + j;
+        }
+    }
+
+    int alteracoes = 0, numRondas = 0;
+    int orcamento = obterOrcamentoSondagem();
+    for (;;) {
+        int feitas = 0;
+
+        if (fila.numBrancas > 0) {
+            // Regra 1: só cria riscadas, por isso esvazia a fila das brancas de uma vez
+            while (fila.numBrancas > 0) {
+                int k = fila.brancas[--fila.numBrancas], i = k / jogo->colunas, j = k % jogo->colunas;
+                char atual = jogo->tabuleiro[i][j];
+                char letraMinuscula = atual + 32;
+
+                Mascara alvo = mascaraEstadoLinha(jogo, i, letraMinuscula);
+                while (alvo) {
+                    int c = __builtin_ctzll(alvo);
+                    alvo &= alvo - 1;
+                    printf("Ajuda: riscar %c%c (igual a branca %c na linha %d)\n", 'a' + c, '1' + i, atual, i+1);
+                    decidirCasaAjuda(jogo, &fila, i, c, '#');
+                    feitas++;
+                }
+
+                alvo = mascaraEstadoColuna(jogo, j, letraMinuscula);
+                while (alvo) {
+                    int l = __builtin_ctzll(alvo);
+                    alvo &= alvo - 1;
+                    printf("Ajuda: riscar %c%c (igual a branca %c na coluna %c)\n", 'a' + j, '1' + l, atual, 'a'+j);
+                    decidirCasaAjuda(jogo, &fila, l, j, '#');
+                    feitas++;
+                }
+            }
+        } else if (fila.numRiscadas > 0) {
+            // Regra 2: só cria brancas, por isso esvazia a fila das riscadas de uma vez
+            while (fila.numRiscadas > 0) {
+                int k = fila.riscadas[--fila.numRiscadas], i = k / jogo->colunas, j = k % jogo->colunas;
+                int p = INDICE_CELULA(jogo, i, j);
+                for (int d = 0; d < 4; d++) {
+                    int q = p + jogo->deslocamentos[d];
+                    char viz = jogo->celulas[q];
+                    if (viz >= 'a' && viz <= 'z') {
+                        int ni = q / jogo->largura - 1, nj = q % jogo->largura;
+                        printf("Ajuda: pintar %c%c (vizinho de casa riscada em %c%d)\n", 'a' + nj, '1' + ni, 'a'+j, i+1);
+                        decidirCasaAjuda(jogo, &fila, ni, nj, viz - 32);
+                        feitas++;
+                    }
+                }
+            }
+        } else {
+            // Regra 3: passagem global, feita apenas quando as filas esvaziam
+            AreaTrabalho *trabalho = obterAreaTrabalho(jogo);
+            char *articulacao = trabalho ? trabalho->articulacao : NULL;
+            if (articulacao && calcularPontosArticulacao(jogo, articulacao) > 0) {
+                for (int i = 0; i < jogo->linhas; i++) {
+                    for (int j = 0; j < jogo->colunas; j++) {
+                        char c = jogo->tabuleiro[i][j];
+                        if (articulacao[i * jogo->colunas + j] && c >= 'a' && c <= 'z') {
+                            printf("Ajuda: pintar de branco %c%c (evita isolamento)\n", 'a' + j, '1' + i);
+                            decidirCasaAjuda(jogo, &fila, i, j, c - 32);
+                            feitas++;
+                        }
+                    }
+                }
+            }
+            // Regra 4: a tabela de deduções, quando nada mais resulta
+            if (feitas == 0) {
+                feitas = aplicarRegrasDeducao(jogo, 1, decidirCasaRegra, &fila, disparos);
+            }
+            // Por fim, a sondagem
+            if (feitas == 0) {
+                feitas = sondarCasas(jogo, &orcamento, fixarCasaSondagem, &fila, NULL);
+                if (feitas <= 0) break;
+            }
+        }
+
+        alteracoes += feitas;
+        if (feitas > 0) numRondas++;
+        if (fila.semMemoria) break;     // As casas por decidir voltariam a ser encontradas
+    }
+
+    if (alteracoes == 0) {
+        printf("Nenhuma jogada inferida disponível no momento.\n");
+    }
+
+    voltarArena(arena, marca);
+    if (rondas) *rondas = numRondas;
+    return alteracoes;
+}
+
 
 Jogo* copiarJogo(Jogo* original) {
     if (!original) return NULL;
@@ -797,47 +1762,35 @@ Jogo* copiarJogo(Jogo* original) {
     copia->linhas = original->linhas;
     copia->colunas = original->colunas;
     copia->modoAjudaAtiva = original->modoAjudaAtiva;
-    copia->historicoMovimentos = NULL;
-    copia->agrupandoMovimentos = original->agrupandoMovimentos;
-    copia->grupoMovimentos = NULL;
-    
-    copia->tabuleiro = malloc(copia->linhas * sizeof(char*));
-    if (!copia->tabuleiro) {
+    copia->historico = (HistoricoMovimentos){ .inicioGrupo = -1 };
+    copia->mascaras = NULL;
+    copia->uniao = NULL;
+    copia->trabalho = NULL;
+    copia->arena = NULL;
+    copia->inicial = NULL;
+    
+    if (alocarTabuleiro(copia) != 0) {
         free(copia);
         return NULL;
     }
     
-    for (int i = 0; i < copia->linhas; i++) {
-        copia->tabuleiro[i] = malloc((copia->colunas + 1) * sizeof(char));
-        if (!copia->tabuleiro[i]) {
-            for (int j = 0; j < i; j++) free(copia->tabuleiro[j]);
-            free(copia->tabuleiro);
-            free(copia);
-            return NULL;
-        }
-        strcpy(copia->tabuleiro[i], original->tabuleiro[i]);
+    // O tabuleiro é um único vetor: uma cópia basta
+    int tamanho = (copia->linhas + 2) * copia->largura;
+    memcpy(copia->celulas, original->celulas, tamanho);
+    
+    copia->mascaras = criarMascaras(copia);
+    copia->uniao = criarUniaoRiscadas(copia);
+    copia->inicial = original->inicial ? malloc(tamanho) : NULL;
+    if (!copia->mascaras || !copia->uniao || (original->inicial && !copia->inicial)) {
+        freeJogo(copia);
+        return NULL;
     }
+    if (copia->inicial) memcpy(copia->inicial, original->inicial, tamanho);
     
     // Copiar histórico de movimentos
-    Movimento *orig = original->historicoMovimentos;
-    Movimento **dest = &(copia->historicoMovimentos);
-    
-    while (orig) {
-        *dest = malloc(sizeof(Movimento));
-        if (!*dest) {
-            freeHistoricoMovimentos(copia->historicoMovimentos);
-            for (int i = 0; i < copia->linhas; i++) free(copia->tabuleiro[i]);
-            free(copia->tabuleiro);
-            free(copia);
-            return NULL;
-        }
-        (*dest)->linha = orig->linha;
-        (*dest)->coluna = orig->coluna;
-        (*dest)->estadoAnterior = orig->estadoAnterior;
-        (*dest)->proximo = NULL;
-        
-        dest = &((*dest)->proximo);
-        orig = orig->proximo;
+    if (copiarHistoricoMovimentos(&copia->historico, &original->historico) != 0) {
+        freeJogo(copia);
+        return NULL;
     }
     
     return copia;
@@ -847,32 +1800,19 @@ Jogo* copiarJogo(Jogo* original) {
 void restaurarJogo(Jogo* destino, Jogo* origem) {
     if (!destino || !origem) return;
 
-    // Copiar tabuleiro
+    // Copiar tabuleiro, mantendo as máscaras em sincronia
     for (int i = 0; i < destino->linhas; i++) {
-        strcpy(destino->tabuleiro[i], origem->tabuleiro[i]);
+        for (int j = 0; j < destino->colunas; j++) {
+            alterarCelula(destino, i, j, origem->tabuleiro[i][j]);
+        }
+    }
+    if (destino->inicial && origem->inicial) {
+        memcpy(destino->inicial, origem->inicial, (destino->linhas + 2) * destino->largura);
     }
 
-    // Copiar histórico
-    freeHistoricoMovimentos(destino->historicoMovimentos);
-    destino->historicoMovimentos = NULL;
-
-    Movimento *orig = origem->historicoMovimentos;
-    Movimento **dest = &(destino->historicoMovimentos);
-    int falhaAloc = 0;
-
-    while (orig && !falhaAloc) {
-        Movimento *novo = malloc(sizeof(Movimento));
-        if (!novo) {
-            falhaAloc = 1;
-        } else {
-            novo->linha = orig->linha;
-            novo->coluna = orig->coluna;
-            novo->estadoAnterior = orig->estadoAnterior;
-            novo->proximo = NULL;
-            *dest = novo;
-            dest = &((*dest)->proximo);
-        }
-        orig = orig->proximo;
+    // Copiar histórico (sem memória, o destino fica com o histórico que tinha)
+    if (copiarHistoricoMovimentos(&destino->historico, &origem->historico) != 0) {
+        printf("Erro na alocação de memória para o histórico.\n");
     }
 }
 
@@ -886,17 +1826,10 @@ int movimentoValido(Jogo *jogo, int linha, int coluna) {
         if (existeDuplicadoNaLinha(jogo, linha, coluna, celula)) return 0;
         if (existeDuplicadoNaColuna(jogo, coluna, linha, celula)) return 0;
     } else if (celula == '#') {
-        int vizinhos[][2] = {{-1,0}, {1,0}, {0,-1}, {0,1}};
+        int p = INDICE_CELULA(jogo, linha, coluna);
         for (int v = 0; v < 4; v++) {
-            int ni = linha + vizinhos[v][0];
-            int nj = coluna + vizinhos[v][1];
-
-            if (ni >= 0 && ni < jogo->linhas && nj >= 0 && nj < jogo->colunas) {
-                char vizinho = jogo->tabuleiro[ni][nj];
-                int ignorar = (vizinho >= 'a' && vizinho <= 'z');
-                if (!ignorar && vizinho == '#') {
-                    return 0;
-                }
+            if (jogo->celulas[p + jogo->deslocamentos[v]] == '#') {
+                return 0;
             }
         }
     }
@@ -905,6 +1838,10 @@ int movimentoValido(Jogo *jogo, int linha, int coluna) {
 }
 
 int resolverJogo(Jogo *jogo) {
+    return resolverJogoComThreads(jogo, 1);
+}
+
+int resolverJogoComThreads(Jogo *jogo, int numThreads) {
     if (!jogo) {
         printf("Erro: Jogo inválido.\n");
         return -1;
@@ -912,22 +1849,18 @@ int resolverJogo(Jogo *jogo) {
     
     printf("Iniciando resolução do jogo...\n");
     
-    // Fase 1: Resetar o tabuleiro para o estado inicial
-    printf("Resetando tabuleiro para o estado inicial...\n");
-    int movimentosDesfeitos = 0;
-    
-    // Desfazer todos os movimentos até voltar ao estado inicial
-    while (jogo->historicoMovimentos != NULL) {
-        if (desfazerMovimento(jogo) == 0) {
-            movimentosDesfeitos++;
-        } else {
-            printf("Erro ao desfazer movimento.\n");
-            return -1;
-        }
+    // Fase 1: Repor o tabuleiro inicial de uma vez, qualquer que seja o tamanho do histórico
+    int casasRepostas = reporTabuleiroInicial(jogo);
+    if (casasRepostas < 0) {
+        printf("Erro: Não foi possível repor o tabuleiro inicial.\n");
+        return -1;
     }
     
-    printf("Total de movimentos desfeitos: %d\n", movimentosDesfeitos);
-    printf("Tabuleiro resetado para o estado inicial.\n\n");
+    if (casasRepostas > 0) {
+        printf("Tabuleiro reposto no estado inicial (%d casas; 'd' desfaz a reposição).\n\n", casasRepostas);
+    } else {
+        printf("O tabuleiro já está no estado inicial: nada a repor.\n\n");
+    }
     
     // Verificar se realmente está no estado inicial (todas minúsculas)
     for (int i = 0; i < jogo->linhas; i++) {
@@ -940,140 +1873,115 @@ int resolverJogo(Jogo *jogo) {
         }
     }
     
-    // Fase 2: Resolver usando backtracking
-    printf("Iniciando resolução por backtracking...\n");
-    
-    // Criar uma cópia do jogo para não afetar o original durante tentativas
-    Jogo *jogoTentativa = copiarJogo(jogo);
-    if (!jogoTentativa) {
-        printf("Erro ao criar cópia do jogo.\n");
-        return -1;
+    // Fase 2: Resolver por procura com propagação de deduções
+    if (numThreads > 1) {
+        printf("Iniciando resolução com propagação de restrições (%d threads)...\n", numThreads);
+    } else {
+        printf("Iniciando resolução com propagação de restrições...\n");
     }
     
-    // Chamar função de backtracking
-    int resultado = backtrackingResolver(jogoTentativa);
+    // A procura trabalha no próprio jogo e desfaz as tentativas pelo rasto; os movimentos da solução
+    // são as diferenças para o tabuleiro inicial
+    EstatisticasResolver estatisticas = {0};
+    int resultado = resolverParalelo(jogo, numThreads, &estatisticas);
+    printf("Nós explorados: %ld, retrocessos: %ld, deduções: %ld, sondagens: %ld\n",
+           estatisticas.nos, estatisticas.retrocessos, estatisticas.deducoes, estatisticas.sondagens);
+    printf("Nogoods aprendidos: %ld (usos: %ld, memória: %ld bytes), saltos no retrocesso: %ld\n",
+           estatisticas.nogoods, estatisticas.usosNogoods, estatisticas.memoriaNogoods, estatisticas.saltos);
+    printf("Tabela de transposição: %ld acertos, %ld falhas\n",
+           estatisticas.acertosTransposicao, estatisticas.falhasTransposicao);
+    if (estatisticas.memoriaTarefas > 0) printf("Memória das tarefas paralelas: %ld bytes\n", estatisticas.memoriaTarefas);
+    for (int r = 0; r < NUM_REGRAS; r++) {
+        if (estatisticas.disparosRegras[r] > 0) printf("Casas decididas pela regra %s: %ld\n", REGRAS_DEDUCAO[r].nome, estatisticas.disparosRegras[r]);
+    }
     
     if (resultado == 1) {
-        // Sucesso: copiar solução de volta para o jogo original
         printf("Solução encontrada! Aplicando ao jogo...\n");
         
-        // Aplicar cada movimento encontrado ao jogo original
+        // Registar um movimento por cada casa que a solução alterou
+        int porRegistar = 0;
         for (int i = 0; i < jogo->linhas; i++) {
             for (int j = 0; j < jogo->colunas; j++) {
-                char estadoOriginal = jogo->tabuleiro[i][j];
-                char estadoSolucao = jogoTentativa->tabuleiro[i][j];
-                
-                // Se o estado mudou, registar o movimento
-                if (estadoOriginal != estadoSolucao) {
-                    jogo->tabuleiro[i][j] = estadoSolucao;
-                    registarMovimento(jogo, i, j, estadoOriginal);
+                char estadoOriginal = jogo->inicial[INDICE_CELULA(jogo, i, j)];
+                if (estadoOriginal != jogo->tabuleiro[i][j] && registarMovimento(jogo, i, j, estadoOriginal) != 0) {
+                    // Sem memória para o histórico, a casa volta ao que o histórico diz
+                    alterarCelula(jogo, i, j, estadoOriginal);
+                    porRegistar++;
                 }
             }
         }
-        
+        if (porRegistar > 0) {
+            printf("Erro: %d casas da solução ficaram por aplicar por falta de memória.\n", porRegistar);
+            return -1;
+        }
         printf("Jogo resolvido com sucesso!\n");
         
         // Verificar se a solução está correta
         if (verificarVitoria(jogo)) {
             printf("Verificação: Solução válida!\n");
-            freeJogo(jogoTentativa);
             return 0; // Retorna 0 para que a main desenhe o jogo e verifique vitória
         } else {
             printf("Aviso: Solução pode não estar completamente correta.\n");
-            freeJogo(jogoTentativa);
             return -1; // Retorna -1 para indicar erro
         }
         
-    } else if (resultado == 0) {
+    }
+    
+    if (resultado == 0) {
         printf("Nenhuma solução encontrada para este tabuleiro.\n");
-        freeJogo(jogoTentativa);
-        return -1; 
     } else {
         printf("Erro durante a resolução do jogo.\n");
-        freeJogo(jogoTentativa);
-        return -1; // Retorna -1 para indicar erro
     }
+    return -1;
 }
 
-// Função auxiliar melhorada para backtracking
+// Mantida por compatibilidade: delega no resolvedor com propagação
 int backtrackingResolver(Jogo *jogo) {
     if (!jogo) return -1;
-    
-    // Verificar se o jogo já está resolvido
-    if (verificarVitoria(jogo)) {
-        return 1; // Solução encontrada
+    return resolverComPropagacao(jogo, NULL);
+}
+
+// Conta as soluções que completam o tabuleiro atual, sem o alterar, e pára ao chegar a limite
+// (2 basta para saber se a solução é única). Devolve o número de soluções encontradas ou -1 em erro.
+int contarSolucoesJogo(Jogo *jogo, int limite) {
+    if (!jogo || limite < 1) {
+        printf("Erro: Jogo inválido.\n");
+        return -1;
     }
     
-    // Encontrar a próxima casa vazia (minúscula) para processar
-    for (int i = 0; i < jogo->linhas; i++) {
-        for (int j = 0; j < jogo->colunas; j++) {
-            char celula = jogo->tabuleiro[i][j];
-            
-            // Se é uma letra minúscula, podemos tentar pintá-la ou riscá-la
-            if (celula >= 'a' && celula <= 'z') {
-                
-                // Tentar pintar de branco (maiúscula)
-                char estadoOriginal = jogo->tabuleiro[i][j];
-                jogo->tabuleiro[i][j] = toupper(celula);
-                
-                // Verificar se este movimento é válido
-                if (movimentoValido(jogo, i, j)) {
-                    // Recursão: tentar resolver o resto
-                    int resultado = backtrackingResolver(jogo);
-                    if (resultado == 1) {
-                        return 1; // Solução encontrada
-                    }
-                }
-                
-                // Desfazer movimento (pintar de branco)
-                jogo->tabuleiro[i][j] = estadoOriginal;
-                
-                // Tentar riscar (#)
-                jogo->tabuleiro[i][j] = '#';
-                
-                // Verificar se este movimento é válido
-                if (movimentoValido(jogo, i, j)) {
-                    // Recursão: tentar resolver o resto
-                    int resultado = backtrackingResolver(jogo);
-                    if (resultado == 1) {
-                        return 1; // Solução encontrada
-                    }
-                }
-                
-                // Desfazer movimento (riscar)
-                jogo->tabuleiro[i][j] = estadoOriginal;
-                
-                // Se nenhuma das opções funcionou, retornar falha
-                return 0;
-            }
-        }
+    EstatisticasResolver estatisticas = {0};
+    int encontradas = contarSolucoes(jogo, limite, NULL, &estatisticas);
+    if (encontradas < 0) {
+        printf("Erro durante a contagem de soluções.\n");
+        return -1;
     }
+    printf("Nós explorados: %ld, retrocessos: %ld, deduções: %ld, nogoods: %ld, acertos na tabela: %ld\n",
+           estatisticas.nos, estatisticas.retrocessos, estatisticas.deducoes, estatisticas.nogoods,
+           estatisticas.acertosTransposicao);
     
-    // Se chegamos aqui, todas as casas foram processadas
-    // Verificar se é uma solução válida
-    return verificarVitoria(jogo) ? 1 : 0;
+    if (encontradas == 0) {
+        printf("Nenhuma solução a partir do estado atual.\n");
+    } else if (encontradas < limite) {
+        if (encontradas == 1) printf("Solução única.\n");
+        else printf("%d soluções.\n", encontradas);
+    } else {
+        printf("Pelo menos %d soluções (limite atingido).\n", encontradas);
+    }
+    return encontradas;
 }
 
 
 // função para verificar se o jogo está completamente resolvido
+// Sem casas por decidir não há vizinhos por pintar e as brancas são as não riscadas, por isso
+// bastam os contadores das máscaras e a união de riscadas: O(1), sem escrever no terminal
 int verificarVitoria(Jogo *jogo) {
-    if (!jogo) return 0;
-    
-    // Verifica se todas as células estão resolvidas (sem letras minúsculas)
-    for (int i = 0; i < jogo->linhas; i++) {
-        for (int j = 0; j < jogo->colunas; j++) {
-            if (islower(jogo->tabuleiro[i][j])) {
-                return 0; // Ainda existem células não resolvidas
-            }
-        }
-    }
-    
-    // Verifica se o tabuleiro está em um estado válido
-    if (verificarRestricoes(jogo) != 0) {
-        return 0; // Há violações de restrições
-    }
-    
-    return 1; // Jogo resolvido e válido
+    if (!jogo || !jogo->mascaras) return 0;
+
+    MascarasTabuleiro *m = jogo->mascaras;
+    if (m->indecisas > 0) return 0;         // Ainda existem células não resolvidas
+    if (m->excessoLetras > 0 || m->paresRiscados > 0) return 0;
+
+    return regiaoNaoRiscadaConexa(jogo);
 }
 
 
@@ -1082,6 +1990,40 @@ int verificarVitoria(Jogo *jogo) {
 
 
 
+// Comandos do jogo, pela ordem em que aparecem no menu inicial e na ajuda dos comandos inválidos
+static const char *COMANDOS[][2] = {
+    {"l <arquivo.txt>", "Carregar jogo"},
+    {"g <arquivo.txt>", "Gravar jogo"},
+    {"b <posicao>", "Pintar de branco"},
+    {"r <posicao>", "Riscar"},
+    {"d [n]", "Desfazer último movimento (ou os últimos n)"},
+    {"f [n]", "Refazer movimento desfeito (ou os próximos n)"},
+    {"i <n>", "Ir para o estado depois dos primeiros n movimentos"},
+    {"v", "Verificar restrições"},
+    {"a", "Ajudar (inferir próximos movimentos)"},
+    {"A", "Ativar modo de ajuda automático"},
+    {"R [n]", "Resolver jogo automaticamente (com n threads)"},
+    {"C [n]", "Contar soluções (até n, por omissão 2: diz se é única)"},
+    {"H [nome]", "Ver ou escolher a heurística do resolvedor"},
+    {"P [n]", "Ver ou mudar o orçamento da sondagem"},
+    {"T [kb]", "Ver ou mudar a memória da tabela de transposição"},
+    {"M", "Ver a memória do histórico e da arena do jogo"},
+    {"s", "Sair do jogo"},
+};
+
+void exibirComandos(void) {
+    for (size_t k = 0; k < sizeof(COMANDOS) / sizeof(COMANDOS[0]); k++) {
+        printf("  %-17s - %s\n", COMANDOS[k][0], COMANDOS[k][1]);
+    }
+}
+
+static int comandoInvalido(const char *comando) {
+    printf("Comando inválido: %s\n", comando);
+    printf("Comandos válidos:\n");
+    exibirComandos();
+    return -1;
+}
+
 int processarComandos(Jogo **jogo, char *comando) {
     if (!jogo || !comando) return -1;
 
@@ -1109,15 +2051,7 @@ int processarComandos(Jogo **jogo, char *comando) {
         if (sscanf(comando, "l %99s", arquivo) == 1) {
             // Liberta o jogo anterior se existir
             if (*jogo) {
-                for (int i = 0; i < (*jogo)->linhas; i++) {
-                    free((*jogo)->tabuleiro[i]);
-                }
-                free((*jogo)->tabuleiro);
-                
-                // Liberta a memória do histórico de movimentos
-                freeHistoricoMovimentos((*jogo)->historicoMovimentos);
-                
-                free(*jogo);
+                freeJogo(*jogo);
                 *jogo = NULL;
             }
             
@@ -1127,6 +2061,51 @@ int processarComandos(Jogo **jogo, char *comando) {
         }
     }
 
+    // "H" mostra a heurística de ramificação do resolvedor e "H <nome>" escolhe outra
+    if (comando[0] == 'H' && (comando[1] == '\0' || comando[1] == ' ')) {
+        if (comando[1] == ' ') {
+            int heuristica = procurarHeuristica(comando + 2);
+            if (heuristica < 0) {
+                printf("Heurística desconhecida: %s\n", comando + 2);
+                return -1;
+            }
+            definirHeuristica(heuristica);
+        }
+        printf("Heurística de ramificação: %s (disponíveis:", NOMES_HEURISTICAS[obterHeuristica()]);
+        for (int h = 0; h < NUM_HEURISTICAS; h++) printf(" %s", NOMES_HEURISTICAS[h]);
+        printf(")\n");
+        return 0;
+    }
+
+    // "P" mostra o orçamento da sondagem e "P <n>" muda-o (0 desativa a sondagem)
+    int orcamento;
+    char sobra;
+    if (comando[0] == 'P' && (comando[1] == '\0' || comando[1] == ' ')) {
+        if (comando[1] == ' ') {
+            if (sscanf(comando, "P %d %c", &orcamento, &sobra) != 1 || orcamento < 0) {
+                printf("Orçamento inválido: %s\n", comando + 2);
+                return -1;
+            }
+            definirOrcamentoSondagem(orcamento);
+        }
+        printf("Orçamento da sondagem: %d valores experimentados por ajuda ou resolução\n", obterOrcamentoSondagem());
+        return 0;
+    }
+
+    // "T" mostra a memória da tabela de transposição e "T <kb>" muda-a (0 desativa a tabela)
+    int kilobytes;
+    if (comando[0] == 'T' && (comando[1] == '\0' || comando[1] == ' ')) {
+        if (comando[1] == ' ') {
+            if (sscanf(comando, "T %d %c", &kilobytes, &sobra) != 1 || kilobytes < 0) {
+                printf("Memória inválida: %s\n", comando + 2);
+                return -1;
+            }
+            definirMemoriaTransposicao((size_t)kilobytes * 1024);
+        }
+        printf("Tabela de transposição: %zu KB por resolução\n", obterMemoriaTransposicao() / 1024);
+        return 0;
+    }
+
     // Para os demais comandos, é necessário verificar se o jogo existe
     if (!(*jogo)) {
         printf("Jogo não carregado. Use 'l <arquivo>' para carregar um jogo.\n");
@@ -1138,6 +2117,31 @@ int processarComandos(Jogo **jogo, char *comando) {
     if (strcmp(comando, "d") == 0) {
         return desfazerMovimento(*jogo);
     }
+
+    // "d <n>" desfaz n movimentos de uma vez, "f [n]" refaz e "i <n>" vai para o estado depois de n movimentos
+    int quantidade;
+    if (strcmp(comando, "f") == 0) {
+        return refazerMovimento(*jogo);
+    }
+    if ((comando[0] == 'd' || comando[0] == 'f' || comando[0] == 'i') && comando[1] == ' ') {
+        if (sscanf(comando + 1, " %d %c", &quantidade, &sobra) != 1 || quantidade < 0) {
+            printf("Número de movimentos inválido: %s\n", comando + 2);
+            return -1;
+        }
+        // Comparar com o que há no histórico antes de somar, para 'f' não transbordar
+        HistoricoMovimentos *historico = &(*jogo)->historico;
+        int maximo = comando[0] == 'd' ? historico->numMovimentos :
+                     comando[0] == 'f' ? historico->fim - historico->numMovimentos : historico->fim;
+        if (quantidade > maximo) {
+            printf("Número de movimentos fora do histórico: %d (no máximo %d).\n", quantidade, maximo);
+            return -1;
+        }
+        int alvo = comando[0] == 'd' ? historico->numMovimentos - quantidade :
+                   comando[0] == 'f' ? historico->numMovimentos + quantidade : quantidade;
+        if (irParaMovimento(*jogo, alvo) != 0) return -1;
+        printf("Histórico no movimento %d de %d.\n", historico->numMovimentos, historico->fim);
+        return 0;
+    }
     
     // Comando para verificar restrições
     if (strcmp(comando, "v") == 0) {
@@ -1164,44 +2168,24 @@ int processarComandos(Jogo **jogo, char *comando) {
         }
         
         printf("Executando ajuda automática contínua...\n");
-        int totalAlteracoes = 0;
-        int iteracao = 1;
-        int alteracoesNaIteracao;
         
         // Inicia o agrupamento de movimentos
         iniciarAgrupamentoMovimentos(*jogo);
         
-        int resolvido = 0;
-        do {
-            printf("\n--- Iteração %d ---\n", iteracao);
-            
-            alteracoesNaIteracao = ajudar(*jogo);
-            
-            if (alteracoesNaIteracao > 0) {
-                totalAlteracoes += alteracoesNaIteracao;
-                printf("Alterações feitas nesta iteração: %d\n", alteracoesNaIteracao);
-
-                printf("\nTabuleiro após iteração %d:\n", iteracao);
-                desenhaJogo(*jogo);
-
-                if (verificarVitoria(*jogo)) {
-                    printf("Jogo completamente resolvido!\n");
-                    resolvido = 1;  // Encerrar o loop
-                }
-
-                iteracao++;
-            } else {
-                printf("Nenhuma alteração possível nesta iteração.\n");
-            }
-
-        } while (alteracoesNaIteracao > 0 && !resolvido);
+        int rondas = 0;
+        long disparos[NUM_REGRAS] = {0};
+        int totalAlteracoes = ajudaAutomatica(*jogo, &rondas, disparos);
+        if (totalAlteracoes < 0) totalAlteracoes = 0;
         
         // Finaliza o agrupamento de movimentos
         finalizarAgrupamentoMovimentos(*jogo);
         
         printf("\n=== Resumo da Ajuda Automática ===\n");
-        printf("Total de iterações executadas: %d\n", iteracao);
+        printf("Total de rondas com alterações: %d\n", rondas);
         printf("Total de alterações realizadas: %d\n", totalAlteracoes);
+        for (int r = 0; r < NUM_REGRAS; r++) {
+            if (disparos[r] > 0) printf("Casas decididas pela regra %s: %ld\n", REGRAS_DEDUCAO[r].nome, disparos[r]);
+        }
         
         if (totalAlteracoes > 0) {
             printf("Processo de ajuda automática concluído.\n");
@@ -1211,10 +2195,13 @@ int processarComandos(Jogo **jogo, char *comando) {
             if (verificarVitoria(*jogo)) {
                 printf("Parabéns! O jogo foi completamente resolvido!\n");
             } else {
-                // Mostra se há violações
-                int violacoes = verificarRestricoes(*jogo);
+                // Só o resumo: o detalhe fica para o comando 'v'
+                ResultadoValidacao resultado = { .lista = NULL };
+                int violacoes = validarTabuleiro(*jogo, &resultado);
                 if (violacoes == 0) {
                     printf("Não há violações, mas o jogo ainda não está completo.\n");
+                } else if (violacoes > 0) {
+                    printf("Há %d violações. Use 'v' para as ver.\n", violacoes);
                 }
             }
         } else {
@@ -1232,6 +2219,45 @@ int processarComandos(Jogo **jogo, char *comando) {
         }
         return resolverJogo(*jogo);
     }
+
+    // "R <n>" resolve com n threads
+    int numThreads;
+    char resto;
+    if (comando[0] == 'R' && comando[1] == ' ' && sscanf(comando, "R %d %c", &numThreads, &resto) == 1) {
+        if (!(*jogo)) {
+            printf("Jogo não carregado. Use 'l <arquivo>' para carregar um jogo.\n");
+            return -1;
+        }
+        if (numThreads < 1 || numThreads > MAX_THREADS) {
+            printf("Número de threads inválido: %d (1 a %d).\n", numThreads, MAX_THREADS);
+            return -1;
+        }
+        return resolverJogoComThreads(*jogo, numThreads);
+    }
+
+    // "C" conta as soluções até à segunda e "C <n>" até n
+    int limite = 2;
+    if (comando[0] == 'C' && (comando[1] == '\0' || comando[1] == ' ')) {
+        if (comando[1] == ' ' && (sscanf(comando, "C %d %c", &limite, &sobra) != 1 || limite < 1)) {
+            printf("Limite inválido: %s\n", comando + 2);
+            return -1;
+        }
+        return contarSolucoesJogo(*jogo, limite) < 0 ? -1 : 0;
+    }
+
+    // "M" mostra a memória do histórico e da arena usada pelo resolvedor e pela ajuda
+    if (strcmp(comando, "M") == 0) {
+        HistoricoMovimentos *historico = &(*jogo)->historico;
+        size_t bytesPontos = (size_t)historico->capacidadePontos * (((*jogo)->linhas * (*jogo)->colunas + 3) / 4);
+        printf("Histórico: %d movimentos (%zu bytes reservados)\n",
+               historico->numMovimentos, historico->capacidade * sizeof(Movimento));
+        printf("Pontos de restauro: %d (%zu bytes reservados)\n", historico->numPontos, bytesPontos);
+        EstatisticasArena e = (*jogo)->arena ? (*jogo)->arena->estatisticas : (EstatisticasArena){0};
+        printf("Arena: %ld reservas, %ld blocos do sistema, %ld blocos reaproveitados\n",
+               e.reservas, e.blocos, e.reutilizacoes);
+        printf("Arena: %zu bytes em uso, pico de %zu bytes, %zu bytes em blocos\n", e.emUso, e.pico, e.total);
+        return 0;
+    }
     
     
 
@@ -1239,19 +2265,7 @@ int processarComandos(Jogo **jogo, char *comando) {
     char tipoComando;
     char posicao[3] = {0}; // Inicializa com zeros
     if (sscanf(comando, "%c %2s", &tipoComando, posicao) != 2) {
-        printf("Comando inválido: %s\n", comando);
-        printf("Comandos válidos:\n");
-        printf("  l <arquivo.txt>   - Carregar jogo\n");
-        printf("  g <arquivo.txt>   - Gravar jogo\n");
-        printf("  b <posicao>       - Pintar de branco\n");
-        printf("  r <posicao>       - Riscar\n");
-        printf("  d                 - Desfazer último movimento\n");
-        printf("  v                 - Verificar restrições\n");
-        printf("  a                 - Ajudar (inferir próximos movimentos)\n");
-        printf("  A                 - Ativar modo de ajuda automático\n");
-        printf("  R                 - Resolver jogo automaticamente\n");
-        printf("  s                 - Sair do jogo\n");
-        return -1;
+        return comandoInvalido(comando);
     }
 
     // Valida formato da posição
@@ -1290,18 +2304,5 @@ int processarComandos(Jogo **jogo, char *comando) {
     
 
     // Se não corresponde a nenhum comando válido
-    printf("Comando inválido: %s\n", comando);
-    printf("Comandos válidos:\n");
-    printf("  l <arquivo.txt>   - Carregar jogo\n");
-    printf("  g <arquivo.txt>   - Gravar jogo\n");
-    printf("  b <posicao>       - Pintar de branco\n");
-    printf("  r <posicao>       - Riscar\n");
-    printf("  d                 - Desfazer último movimento\n");
-    printf("  v                 - Verificar restrições\n");
-    printf("  a                 - Ajudar (inferir próximos movimentos)\n");
-    printf("  A                 - Ativar modo de ajuda automático\n");
-    printf("  R                 - Resolver jogo automaticamente\n");
-    printf("  s                 - Sair do jogo\n");
-    
-    return -1;
+    return comandoInvalido(comando);
 }
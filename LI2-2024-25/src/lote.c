@@ -0,0 +1,257 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include "../include/jogo.h"
+#include "../include/resolver.h"
+#include "../include/lote.h"
+
+#define TAMANHO_CAMINHO 1024
+
+typedef struct {
+    char **ficheiros;
+    int numFicheiros;
+    const char *pastaSaida;
+    atomic_int proximo;         // Índice do próximo ficheiro por tratar
+    ResultadoLote resultado;
+    pthread_mutex_t trinco;     // Protege o resultado e a escrita no terminal
+} Lote;
+
+
+// Lista de ficheiros ==================================================================================
+
+static int compararNomes(const void *a, const void *b) {
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+static int adicionarFicheiro(char ***ficheiros, int *numFicheiros, int *capacidade, const char *caminho) {
+    if (*numFicheiros == *capacidade) {
+        int novaCapacidade = *capacidade ? *capacidade * 2 : 64;
+        char **novos = realloc(*ficheiros, novaCapacidade * sizeof(char *));
+        if (!novos) return -1;
+        *ficheiros = novos;
+        *capacidade = novaCapacidade;
+    }
+    char *copia = malloc(strlen(caminho) + 1);
+    if (!copia) return -1;
+    strcpy(copia, caminho);
+    (*ficheiros)[(*numFicheiros)++] = copia;
+    return 0;
+}
+
+char** listarTabuleiros(const char *entrada, int *numFicheiros) {
+    if (!entrada || !numFicheiros) return NULL;
+
+    char **ficheiros = NULL;
+    int capacidade = 0;
+    int erro = 0;
+    *numFicheiros = 0;
+
+    struct stat info;
+    if (stat(entrada, &info) != 0) {
+        printf("Erro ao abrir %s\n", entrada);
+        *numFicheiros = -1;
+        return NULL;
+    }
+
+    char caminho[TAMANHO_CAMINHO];
+    if (S_ISDIR(info.st_mode)) {
+        DIR *pasta = opendir(entrada);
+        if (!pasta) {
+            printf("Erro ao abrir a pasta %s\n", entrada);
+            *numFicheiros = -1;
+            return NULL;
+        }
+        struct dirent *entradaPasta;
+        while (!erro && (entradaPasta = readdir(pasta)) != NULL) {
+            if (entradaPasta->d_name[0] == '.') continue;
+            snprintf(caminho, sizeof(caminho), "%s/%s", entrada, entradaPasta->d_name);
+            if (stat(caminho, &info) != 0 || !S_ISREG(info.st_mode)) continue;
+            erro = adicionarFicheiro(&ficheiros, numFicheiros, &capacidade, caminho);
+        }
+        closedir(pasta);
+
+        // A ordem do readdir não é definida: ordenar para a saída ser reprodutível
+        if (!erro && *numFicheiros > 1) qsort(ficheiros, *numFicheiros, sizeof(char *), compararNomes);
+    } else {
+        FILE *lista = fopen(entrada, "r");
+        if (!lista) {
+            printf("Erro ao abrir arquivo %s\n", entrada);
+            *numFicheiros = -1;
+            return NULL;
+        }
+        while (!erro && fgets(caminho, sizeof(caminho), lista)) {
+            caminho[strcspn(caminho, "\r\n")] = '\0';
+            if (caminho[0] == '\0' || caminho[0] == '#') continue;
+            erro = adicionarFicheiro(&ficheiros, numFicheiros, &capacidade, caminho);
+        }
+        fclose(lista);
+    }
+
+    if (erro) {
+        printf("Erro na alocação de memória para a lista de tabuleiros.\n");
+        freeListaTabuleiros(ficheiros, *numFicheiros);
+        *numFicheiros = -1;
+        return NULL;
+    }
+    return ficheiros;
+}
+
+void freeListaTabuleiros(char **ficheiros, int numFicheiros) {
+    if (ficheiros != NULL) {
+        for (int k = 0; k < numFicheiros; k++) free(ficheiros[k]);
+        free(ficheiros);
+    }
+}
+
+
+// Resolução ===========================================================================================
+
+static double tempoMs(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000.0 + t.tv_nsec / 1e6;
+}
+
+static const char* nomeBase(const char *caminho) {
+    const char *barra = strrchr(caminho, '/');
+    return barra ? barra + 1 : caminho;
+}
+
+static int compararNomesBase(const void *a, const void *b) {
+    return strcmp(nomeBase(*(char * const *)a), nomeBase(*(char * const *)b));
+}
+
+// A solução de cada tabuleiro fica na pasta de saída com o nome do tabuleiro, por isso dois
+// tabuleiros de pastas diferentes com o mesmo nome escreveriam no mesmo ficheiro.
+// Devolve o número de nomes repetidos (cada um já reportado), ou -1 sem memória.
+static int contarNomesRepetidos(char **ficheiros, int numFicheiros) {
+    if (numFicheiros < 2) return 0;
+
+    char **ordenados = malloc(numFicheiros * sizeof(char *));
+    if (!ordenados) {
+        printf("Erro na alocação de memória para a lista de tabuleiros.\n");
+        return -1;
+    }
+    memcpy(ordenados, ficheiros, numFicheiros * sizeof(char *));
+    qsort(ordenados, numFicheiros, sizeof(char *), compararNomesBase);
+
+    int repetidos = 0;
+    for (int k = 1; k < numFicheiros; k++) {
+        if (compararNomesBase(&ordenados[k - 1], &ordenados[k]) == 0) {
+            printf("Erro: %s e %s teriam a solução no mesmo ficheiro (%s)\n", ordenados[k - 1], ordenados[k], nomeBase(ordenados[k]));
+            repetidos++;
+        }
+    }
+    free(ordenados);
+    return repetidos;
+}
+
+// Escreve a solução no formato do comando 'g' (sem movimentos), para poder ser carregada com 'l'
+static int escreverSolucao(Jogo *jogo, int resolvido, const char *arquivo) {
+    FILE *output = fopen(arquivo, "w");
+    if (!output) return -1;
+
+    if (resolvido) {
+        fprintf(output, "%d %d\n", jogo->linhas, jogo->colunas);
+        for (int i = 0; i < jogo->linhas; i++) fprintf(output, "%s\n", jogo->tabuleiro[i]);
+        fprintf(output, "0\n");
+    } else {
+        fprintf(output, "unsolvable\n");
+    }
+
+    fclose(output);
+    return 0;
+}
+
+static void resolverFicheiro(Lote *lote, const char *ficheiro) {
+    char saida[TAMANHO_CAMINHO];
+    snprintf(saida, sizeof(saida), "%s/%s", lote->pastaSaida, nomeBase(ficheiro));
+
+    double inicio = tempoMs();
+    Jogo *jogo = carregarJogo((char *)ficheiro);
+    EstatisticasResolver estatisticas = {0};
+    // Resolve-se o puzzle e não a posição gravada: os movimentos do ficheiro podem ter erros
+    int resultado = jogo && reporTabuleiroInicial(jogo) >= 0 ? resolverComPropagacao(jogo, &estatisticas) : -1;
+    double fim = tempoMs();
+
+    if (resultado >= 0 && escreverSolucao(jogo, resultado == 1, saida) != 0) {
+        printf("Erro ao abrir arquivo %s para escrita\n", saida);
+        resultado = -1;
+    }
+    freeJogo(jogo);
+
+    const char *estado = resultado == 1 ? "resolvido" : resultado == 0 ? "unsolvable" : "erro";
+    pthread_mutex_lock(&lote->trinco);
+    if (resultado == 1) lote->resultado.resolvidos++;
+    else if (resultado == 0) lote->resultado.semSolucao++;
+    else lote->resultado.erros++;
+    printf("%s\t%s\t%.3f ms\t%ld nós\n", ficheiro, estado, fim - inicio, estatisticas.nos);
+    pthread_mutex_unlock(&lote->trinco);
+}
+
+static void* trabalhadorLote(void *argumento) {
+    Lote *lote = argumento;
+
+    int k;
+    while ((k = atomic_fetch_add(&lote->proximo, 1)) < lote->numFicheiros) {
+        resolverFicheiro(lote, lote->ficheiros[k]);
+    }
+    return NULL;
+}
+
+// Devolve 0 se todos os tabuleiros foram tratados (resolvidos ou sem solução) e -1 se algum falhou
+int resolverLote(const char *entrada, const char *pastaSaida, int numThreads, ResultadoLote *resultado) {
+    if (!entrada || !pastaSaida) return -1;
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > MAX_THREADS) numThreads = MAX_THREADS;
+
+    if (mkdir(pastaSaida, 0755) != 0 && errno != EEXIST) {
+        printf("Erro ao criar a pasta %s\n", pastaSaida);
+        return -1;
+    }
+
+    Lote lote;
+    lote.ficheiros = listarTabuleiros(entrada, &lote.numFicheiros);
+    // Pasta ou lista vazia não é um erro; um caminho inválido ou falta de memória já foram reportados
+    if (lote.numFicheiros < 0) return -1;
+    int repetidos = contarNomesRepetidos(lote.ficheiros, lote.numFicheiros);
+    if (repetidos != 0) {
+        freeListaTabuleiros(lote.ficheiros, lote.numFicheiros);
+        if (resultado) *resultado = (ResultadoLote){0, 0, repetidos > 0 ? repetidos : 1};
+        return -1;
+    }
+    lote.pastaSaida = pastaSaida;
+    lote.resultado = (ResultadoLote){0, 0, 0};
+    atomic_init(&lote.proximo, 0);
+    pthread_mutex_init(&lote.trinco, NULL);
+
+    if (numThreads > lote.numFicheiros) numThreads = lote.numFicheiros > 0 ? lote.numFicheiros : 1;
+
+    double inicio = tempoMs();
+    pthread_t threads[MAX_THREADS];
+    int criadas = 0;
+    for (int t = 1; t < numThreads; t++) {
+        if (pthread_create(&threads[criadas], NULL, trabalhadorLote, &lote) != 0) break;
+        criadas++;
+    }
+    // A thread principal também trabalha, por isso basta ela se não for possível criar outras
+    trabalhadorLote(&lote);
+    for (int t = 0; t < criadas; t++) pthread_join(threads[t], NULL);
+    double fim = tempoMs();
+
+    printf("Total: %d tabuleiros (%d resolvidos, %d unsolvable, %d erros) em %.3f ms com %d threads\n",
+           lote.numFicheiros, lote.resultado.resolvidos, lote.resultado.semSolucao, lote.resultado.erros,
+           fim - inicio, criadas + 1);
+
+    pthread_mutex_destroy(&lote.trinco);
+    freeListaTabuleiros(lote.ficheiros, lote.numFicheiros);
+
+    if (resultado) *resultado = lote.resultado;
+    return lote.resultado.erros > 0 ? -1 : 0;
+}
@@ -2,23 +2,18 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <string.h>
+#include <unistd.h>
 #include "../include/jogo.h"
+#include "../include/resolver.h"
+#include "../include/lote.h"
+#include "../include/gerador.h"
 
 // Função para exibir o menu inicial
 void exibirMenuInicial(void) {
     printf("\n====================Bem-vindo ao jogo Puzzle Hitori!====================\n");
     printf("\nUse 'l <nome_arquivo>' para carregar um jogo.\n");
     printf("Comandos disponíveis:\n");
-    printf("  l <arquivo.txt>   - Carregar jogo\n");
-    printf("  g <arquivo.txt>   - Gravar jogo\n");
-    printf("  b <posicao>       - Pintar de branco\n");
-    printf("  r <posicao>       - Riscar\n");
-    printf("  d                 - Desfazer último movimento\n");
-    printf("  v                 - Verificar restrições\n");
-    printf("  a                 - Ajudar (inferir próximos movimentos)\n");
-    printf("  A                 - Ativar modo de ajuda automático\n");
-    printf("  R                 - Resolver jogo automaticamente\n");
-    printf("  s                 - Sair do jogo\n");
+    exibirComandos();
 }
 
 // Função para exibir a mensagem de vitória e aguardar ENTER
@@ -40,7 +35,147 @@ void exibirMensagemVitoria(void) {
 }
 
 
-int main(void) {
+// Modo não interativo: jogo --solve-batch <pasta|lista> [--out <pasta>] [--threads <n>] [--heuristic <nome>]
+int executarLote(int argc, char *argv[]) {
+    const char *entrada = NULL;
+    const char *saida = SAIDA_LOTE_PADRAO;
+    long processadores = sysconf(_SC_NPROCESSORS_ONLN);
+    int numThreads = processadores > 0 ? (int)processadores : 1;
+
+    for (int k = 1; k < argc; k++) {
+        if (strcmp(argv[k], "--solve-batch") == 0 && k + 1 < argc) {
+            entrada = argv[++k];
+        } else if (strcmp(argv[k], "--out") == 0 && k + 1 < argc) {
+            saida = argv[++k];
+        } else if (strcmp(argv[k], "--threads") == 0 && k + 1 < argc) {
+            numThreads = atoi(argv[++k]);
+            if (numThreads < 1 || numThreads > MAX_THREADS) {
+                printf("Número de threads inválido: %s (1 a %d).\n", argv[k], MAX_THREADS);
+                return 2;
+            }
+        } else if (strcmp(argv[k], "--heuristic") == 0 && k + 1 < argc) {
+            int heuristica = procurarHeuristica(argv[++k]);
+            if (heuristica < 0) {
+                printf("Heurística desconhecida: %s\n", argv[k]);
+                return 2;
+            }
+            definirHeuristica(heuristica);
+        } else {
+            printf("Argumento inválido: %s\n", argv[k]);
+            entrada = NULL;
+            break;
+        }
+    }
+
+    if (!entrada) {
+        printf("Uso: %s --solve-batch <pasta|lista> [--out <pasta>] [--threads <n>] [--heuristic <nome>]\n", argv[0]);
+        return 2;
+    }
+
+    return resolverLote(entrada, saida, numThreads, NULL) == 0 ? 0 : 1;
+}
+
+// Contagem: jogo --count-solutions <arquivo>... [--limit <n>] [--heuristic <nome>]
+// Termina com 0 só se todos os tabuleiros tiverem solução única.
+int executarContagem(int argc, char *argv[]) {
+    int limite = 2;
+    int numArquivos = 0;
+    int valido = 1;
+
+    // Primeiro as opções, para valerem para todos os tabuleiros
+    for (int k = 2; k < argc && valido; k++) {
+        if (strcmp(argv[k], "--limit") == 0 && k + 1 < argc) {
+            limite = atoi(argv[++k]);
+            valido = limite >= 1;
+        } else if (strcmp(argv[k], "--heuristic") == 0 && k + 1 < argc) {
+            int heuristica = procurarHeuristica(argv[++k]);
+            valido = heuristica >= 0;
+            if (valido) definirHeuristica(heuristica);
+        } else if (strncmp(argv[k], "--", 2) == 0) {
+            valido = 0;
+        } else {
+            numArquivos++;
+        }
+        if (!valido) printf("Argumento inválido: %s\n", argv[k]);
+    }
+
+    if (!valido || numArquivos == 0) {
+        printf("Uso: %s --count-solutions <arquivo>... [--limit <n>] [--heuristic <nome>]\n", argv[0]);
+        return 2;
+    }
+
+    int todasUnicas = 1;
+    for (int k = 2; k < argc; k++) {
+        if (strcmp(argv[k], "--limit") == 0 || strcmp(argv[k], "--heuristic") == 0) {
+            k++;
+            continue;
+        }
+
+        Jogo *jogo = carregarJogo(argv[k]);
+        int encontradas = jogo ? contarSolucoes(jogo, limite, NULL, NULL) : -1;
+        if (encontradas < 0) {
+            printf("%s: erro\n", argv[k]);
+        } else if (encontradas < limite) {
+            printf("%s: %d %s\n", argv[k], encontradas, encontradas == 1 ? "solução" : "soluções");
+        } else {
+            printf("%s: pelo menos %d soluções\n", argv[k], encontradas);
+        }
+        if (encontradas != 1 || limite == 1) todasUnicas = 0;
+        freeJogo(jogo);
+    }
+
+    return todasUnicas ? 0 : 1;
+}
+
+// Geração: jogo --generate <quantidade> [--size <L>x<C>] [--density <p>] [--seed <s>] [--out <pasta>] [--threads <n>]
+int executarGerador(int argc, char *argv[]) {
+    ParametrosGerador parametros = {15, 15, 40, 1};
+    const char *saida = SAIDA_GERADOR_PADRAO;
+    int quantidade = -1;
+    long processadores = sysconf(_SC_NPROCESSORS_ONLN);
+    int numThreads = processadores > 0 ? (int)processadores : 1;
+    int valido = 1;
+
+    for (int k = 1; k < argc && valido; k++) {
+        if (strcmp(argv[k], "--generate") == 0 && k + 1 < argc) {
+            quantidade = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "--size") == 0 && k + 1 < argc) {
+            valido = sscanf(argv[++k], "%dx%d", &parametros.linhas, &parametros.colunas) == 2 &&
+                     parametros.linhas >= 1 && parametros.colunas >= 1;
+            if (valido && (parametros.linhas > MAX_DIMENSAO_GERADOR || parametros.colunas > MAX_DIMENSAO_GERADOR)) {
+                printf("O gerador só cria tabuleiros até %dx%d: com %d letras, as linhas maiores precisam de demasiadas riscadas.\n",
+                       MAX_DIMENSAO_GERADOR, MAX_DIMENSAO_GERADOR, NUM_LETRAS);
+                valido = 0;
+            }
+        } else if (strcmp(argv[k], "--density") == 0 && k + 1 < argc) {
+            parametros.densidade = atoi(argv[++k]);
+            valido = parametros.densidade >= 0 && parametros.densidade <= 100;
+        } else if (strcmp(argv[k], "--seed") == 0 && k + 1 < argc) {
+            parametros.semente = strtoull(argv[++k], NULL, 10);
+        } else if (strcmp(argv[k], "--out") == 0 && k + 1 < argc) {
+            saida = argv[++k];
+        } else if (strcmp(argv[k], "--threads") == 0 && k + 1 < argc) {
+            numThreads = atoi(argv[++k]);
+            valido = numThreads >= 1 && numThreads <= MAX_THREADS;
+        } else {
+            valido = 0;
+        }
+        if (!valido) printf("Argumento inválido: %s\n", argv[k]);
+    }
+
+    if (!valido || quantidade < 0) {
+        printf("Uso: %s --generate <quantidade> [--size <L>x<C>] [--density <p>] [--seed <s>] [--out <pasta>] [--threads <n>]\n", argv[0]);
+        return 2;
+    }
+
+    return gerarLoteTabuleiros(saida, quantidade, &parametros, numThreads) == quantidade ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--generate") == 0) return executarGerador(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--count-solutions") == 0) return executarContagem(argc, argv);
+    if (argc > 1) return executarLote(argc, argv);
+
     Jogo *jogo = NULL;
     int sair = 0;
 
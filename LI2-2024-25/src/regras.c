@@ -0,0 +1,167 @@
+#include <ctype.h>
+#include "../include/jogo.h"
+#include "../include/regras.h"
+
+// Letra (minúscula) de uma casa não riscada; 0 para riscadas e sentinelas
+static char letraCasa(char celula) {
+    if (celula >= 'a' && celula <= 'z') return celula;
+    if (celula >= 'A' && celula <= 'Z') return celula + 32;
+    return 0;
+}
+
+static int indecisa(char celula) {
+    return celula >= 'a' && celula <= 'z';
+}
+
+// Sanduíche: se a casa do meio de x?x fosse riscada, as duas vizinhas iguais teriam de ser brancas
+static int regraSanduiche(Jogo *jogo, IdRegra regra, DecidirCasa decidir, void *contexto) {
+    int alteracoes = 0;
+
+    for (int i = 0; i < jogo->linhas; i++) {
+        for (int j = 0; j < jogo->colunas; j++) {
+            int p = INDICE_CELULA(jogo, i, j);
+            char celula = jogo->celulas[p];
+            if (!indecisa(celula)) continue;
+
+            // Eixo vertical (cima, baixo) e depois horizontal (esquerda, direita)
+            for (int d = 0; d < 4; d += 2) {
+                char antes = letraCasa(jogo->celulas[p + jogo->deslocamentos[d]]);
+                char depois = letraCasa(jogo->celulas[p + jogo->deslocamentos[d + 1]]);
+                if (antes && antes == depois) {
+                    decidir(jogo, i, j, toupper(celula), regra, contexto);
+                    alteracoes++;
+                    break;
+                }
+            }
+        }
+    }
+
+    return alteracoes;
+}
+
+// Par adjacente: de xx uma é riscada e a outra branca, por isso as restantes x da linha ou coluna
+// ficam riscadas
+static int regraParAdjacente(Jogo *jogo, IdRegra regra, DecidirCasa decidir, void *contexto) {
+    MascarasTabuleiro *m = jogo->mascaras;
+    int alteracoes = 0;
+
+    for (int i = 0; i < jogo->linhas; i++) {
+        for (int j = 0; j < jogo->colunas; j++) {
+            int p = INDICE_CELULA(jogo, i, j);
+            char letra = letraCasa(jogo->celulas[p]);
+            if (!letra) continue;
+            int l = letra - 'a';
+
+            if (letraCasa(jogo->celulas[p + 1]) == letra) {
+                Mascara alvo = m->letraLinha[l * jogo->linhas + i] & m->indecisasLinha[i] & ~(3ULL << j);
+                while (alvo) {
+                    int k = __builtin_ctzll(alvo);
+                    alvo &= alvo - 1;
+                    decidir(jogo, i, k, '#', regra, contexto);
+                    alteracoes++;
+                }
+            }
+
+            if (letraCasa(jogo->celulas[p + jogo->largura]) == letra) {
+                Mascara alvo = m->letraColuna[l * jogo->colunas + j] & m->indecisasColuna[j] & ~(3ULL << i);
+                while (alvo) {
+                    int k = __builtin_ctzll(alvo);
+                    alvo &= alvo - 1;
+                    decidir(jogo, k, j, '#', regra, contexto);
+                    alteracoes++;
+                }
+            }
+        }
+    }
+
+    return alteracoes;
+}
+
+// Cantos, com c a casa do canto, h e v as suas vizinhas e d a diagonal:
+//  - c = h = v: com c branca, h e v ficariam riscadas e isolariam c, logo c é riscada;
+//  - c = h e v = d (ou c = v e h = d): há uma riscada em cada par e não podem ser adjacentes
+//    nem isolar c, pelo que só resta riscar c e d.
+static int regraCanto(Jogo *jogo, IdRegra regra, DecidirCasa decidir, void *contexto) {
+    if (jogo->linhas < 2 || jogo->colunas < 2) return 0;
+
+    int alteracoes = 0;
+    int cantos[4][2] = { {0, 0}, {0, jogo->colunas - 1}, {jogo->linhas - 1, 0}, {jogo->linhas - 1, jogo->colunas - 1} };
+
+    for (int k = 0; k < 4; k++) {
+        int i = cantos[k][0], j = cantos[k][1];
+        int di = i == 0 ? 1 : -1, dj = j == 0 ? 1 : -1;
+
+        char c = letraCasa(jogo->tabuleiro[i][j]);
+        char h = letraCasa(jogo->tabuleiro[i][j + dj]);
+        char v = letraCasa(jogo->tabuleiro[i + di][j]);
+        char d = letraCasa(jogo->tabuleiro[i + di][j + dj]);
+        if (!c) continue;
+
+        int riscarCanto = c == h && c == v;
+        int riscarDiagonal = (c == h && v && v == d) || (c == v && h && h == d);
+        if (riscarDiagonal) riscarCanto = 1;
+
+        if (riscarCanto && indecisa(jogo->tabuleiro[i][j])) {
+            decidir(jogo, i, j, '#', regra, contexto);
+            alteracoes++;
+        }
+        if (riscarDiagonal && indecisa(jogo->tabuleiro[i + di][j + dj])) {
+            decidir(jogo, i + di, j + dj, '#', regra, contexto);
+            alteracoes++;
+        }
+    }
+
+    return alteracoes;
+}
+
+// Letra única: riscar uma casa sem repetições na linha nem na coluna não resolve nada, e pintá-la
+// numa solução dá outra solução (as vizinhas são brancas). Só vale se a solução for única ou se
+// bastar encontrar uma.
+static int regraLetraUnica(Jogo *jogo, IdRegra regra, DecidirCasa decidir, void *contexto) {
+    if (jogo->linhas * jogo->colunas < 2) return 0;
+
+    MascarasTabuleiro *m = jogo->mascaras;
+    int alteracoes = 0;
+
+    for (int i = 0; i < jogo->linhas; i++) {
+        Mascara indecisas = m->indecisasLinha[i];
+        while (indecisas) {
+            int j = __builtin_ctzll(indecisas);
+            indecisas &= indecisas - 1;
+
+            char celula = jogo->tabuleiro[i][j];
+            int l = celula - 'a';
+            Mascara linha = m->letraLinha[l * jogo->linhas + i];
+            Mascara coluna = m->letraColuna[l * jogo->colunas + j];
+            if (!(linha & (linha - 1)) && !(coluna & (coluna - 1))) {
+                decidir(jogo, i, j, toupper(celula), regra, contexto);
+                alteracoes++;
+            }
+        }
+    }
+
+    return alteracoes;
+}
+
+const RegraDeducao REGRAS_DEDUCAO[NUM_REGRAS] = {
+    [REGRA_SANDUICHE]     = { "sanduiche", "entre duas letras iguais", regraSanduiche, 0, 1 },
+    [REGRA_PAR_ADJACENTE] = { "par_adjacente", "repete um par de letras adjacentes", regraParAdjacente, 0, 1 },
+    [REGRA_CANTO]         = { "canto", "padrão de canto", regraCanto, 0, 1 },
+    [REGRA_LETRA_UNICA]   = { "letra_unica", "letra única na linha e na coluna", regraLetraUnica, 1, 0 },
+};
+
+int aplicarRegrasDeducao(Jogo *jogo, int incluirSolucaoUnica, DecidirCasa decidir, void *contexto, long *disparos) {
+    if (!jogo || !jogo->mascaras || !decidir) return -1;
+
+    for (int r = 0; r < NUM_REGRAS; r++) {
+        if (REGRAS_DEDUCAO[r].exigeSolucaoUnica && !incluirSolucaoUnica) continue;
+
+        int alteracoes = REGRAS_DEDUCAO[r].aplicar(jogo, r, decidir, contexto);
+        if (alteracoes > 0) {
+            if (disparos) disparos[r] += alteracoes;
+            return alteracoes;
+        }
+    }
+
+    return 0;
+}
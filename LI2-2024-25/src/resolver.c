@@ -0,0 +1,1278 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include "../include/jogo.h"
+#include "../include/resolver.h"
+#include "../include/regras.h"
+
+#define CONTRADICAO -1
+
+// Primeira casa por decidir, por ordem de linhas; (-1, -1) se não há nenhuma.
+// O contador das máscaras responde logo quando o tabuleiro está todo decidido.
+static void primeiraIndecisa(Jogo *jogo, int *linha, int *coluna) {
+    *linha = *coluna = -1;
+    if (jogo->mascaras->indecisas == 0) return;
+
+    for (int i = 0; i < jogo->linhas; i++) {
+        Mascara indecisas = jogo->mascaras->indecisasLinha[i];
+        if (indecisas) {
+            *linha = i;
+            *coluna = __builtin_ctzll(indecisas);
+            return;
+        }
+    }
+}
+
+// Heurísticas de ramificação =========================================================================
+
+const char *NOMES_HEURISTICAS[NUM_HEURISTICAS] = { "primeira", "conflitos" };
+
+// Lida por todas as threads da procura; só deve mudar entre resoluções
+static Heuristica heuristicaAtual = HEURISTICA_CONFLITOS;
+
+void definirHeuristica(Heuristica heuristica) {
+    if (heuristica >= 0 && heuristica < NUM_HEURISTICAS) heuristicaAtual = heuristica;
+}
+
+Heuristica obterHeuristica(void) {
+    return heuristicaAtual;
+}
+
+int procurarHeuristica(const char *nome) {
+    for (int h = 0; nome && h < NUM_HEURISTICAS; h++) {
+        if (strcmp(nome, NOMES_HEURISTICAS[h]) == 0) return h;
+    }
+    return -1;
+}
+
+// Casa por decidir com mais repetições da sua letra na linha e na coluna (desempate: vizinha na
+// diagonal de uma riscada, depois ordem de linhas). As vizinhas ortogonais de riscadas já ficaram
+// brancas pela propagação, por isso são as diagonais que ligam a casa às riscadas.
+// Com repetições nas duas direções experimenta primeiro riscar: só uma ocorrência fica branca.
+static void casaMaisConflitos(Jogo *jogo, int *linha, int *coluna, int *riscarPrimeiro) {
+    MascarasTabuleiro *m = jogo->mascaras;
+    int melhor = -1;
+
+    *linha = *coluna = -1;
+    if (m->indecisas == 0) return;
+
+    for (int i = 0; i < jogo->linhas; i++) {
+        Mascara indecisas = m->indecisasLinha[i];
+        if (!indecisas) continue;
+
+        Mascara riscadasVizinhas = (i > 0 ? m->riscadasLinha[i - 1] : 0) |
+                                   (i + 1 < jogo->linhas ? m->riscadasLinha[i + 1] : 0);
+        Mascara diagonais = (riscadasVizinhas << 1) | (riscadasVizinhas >> 1);
+
+        while (indecisas) {
+            int j = __builtin_ctzll(indecisas);
+            indecisas &= indecisas - 1;
+
+            int l = jogo->tabuleiro[i][j] - 'a';
+            int repetidasLinha = __builtin_popcountll(m->letraLinha[l * jogo->linhas + i]) - 1;
+            int repetidasColuna = __builtin_popcountll(m->letraColuna[l * jogo->colunas + j]) - 1;
+            int pontos = 2 * (repetidasLinha + repetidasColuna) + (int)((diagonais >> j) & 1);
+
+            if (pontos > melhor) {
+                melhor = pontos;
+                *linha = i;
+                *coluna = j;
+                *riscarPrimeiro = repetidasLinha > 0 && repetidasColuna > 0;
+            }
+        }
+    }
+}
+
+// Escolhe a casa onde ramificar e a ordem dos valores; (-1, -1) se não há casas por decidir
+static void escolherRamificacao(Jogo *jogo, int *linha, int *coluna, char tentativas[2]) {
+    int riscarPrimeiro = 0;
+
+    if (heuristicaAtual == HEURISTICA_CONFLITOS) {
+        casaMaisConflitos(jogo, linha, coluna, &riscarPrimeiro);
+    } else {
+        primeiraIndecisa(jogo, linha, coluna);
+    }
+    if (*linha == -1) return;
+
+    char branco = toupper(jogo->tabuleiro[*linha][*coluna]);
+    tentativas[0] = riscarPrimeiro ? '#' : branco;
+    tentativas[1] = riscarPrimeiro ? branco : '#';
+}
+
+// Rasto de alterações ================================================================================
+
+Rasto* criarRasto(Jogo *jogo) {
+    if (!jogo) return NULL;
+
+    // Num caminho da procura cada casa muda no máximo uma vez: por decidir -> decidida
+    int capacidade = jogo->linhas * jogo->colunas;
+    Arena *arena = obterArena(jogo);
+    if (!arena) return NULL;
+
+    MarcaArena marca = marcarArena(arena);
+    Rasto *rasto = reservarArena(arena, sizeof(Rasto));
+    int *posicoes = reservarArena(arena, capacidade * sizeof(int));
+    int *niveis = reservarArena(arena, (capacidade + 1) * sizeof(int));
+    char *anteriores = reservarArena(arena, capacidade * sizeof(char));
+    if (!rasto || !posicoes || !niveis || !anteriores) {
+        voltarArena(arena, marca);
+        return NULL;
+    }
+    rasto->posicoes = posicoes;
+    rasto->anteriores = anteriores;
+    rasto->niveis = niveis;
+    rasto->arena = arena;
+    rasto->marca = marca;
+    rasto->topo = 0;
+    rasto->nivel = 0;
+    rasto->capacidade = capacidade;
+    return rasto;
+}
+
+// Devolve à arena do jogo o rasto e tudo o que foi reservado depois dele
+void freeRasto(Rasto *rasto) {
+    if (rasto != NULL) voltarArena(rasto->arena, rasto->marca);
+}
+
+// Altera a casa na posição p do vetor do tabuleiro, guardando o valor anterior no rasto
+static void definirCasa(Jogo *jogo, Rasto *rasto, int p, char novo) {
+    if (rasto && rasto->topo < rasto->capacidade) {
+        rasto->posicoes[rasto->topo] = p;
+        rasto->anteriores[rasto->topo] = jogo->celulas[p];
+        rasto->topo++;
+    }
+    alterarCelula(jogo, p / jogo->largura - 1, p % jogo->largura, novo);
+}
+
+// Marca o início de um novo nível de decisão
+void abrirNivel(Rasto *rasto) {
+    rasto->niveis[rasto->nivel++] = rasto->topo;
+}
+
+// Desfaz, da mais recente para a mais antiga, todas as alterações feitas desde o início do nível
+void voltarAoNivel(Jogo *jogo, Rasto *rasto, int nivel) {
+    if (nivel < 0 || nivel >= rasto->nivel) return;
+
+    int marca = rasto->niveis[nivel];
+    while (rasto->topo > marca) {
+        rasto->topo--;
+        int p = rasto->posicoes[rasto->topo];
+        alterarCelula(jogo, p / jogo->largura - 1, p % jogo->largura, rasto->anteriores[rasto->topo]);
+    }
+    rasto->nivel = nivel;
+}
+
+
+// Tabela de transposição ============================================================================
+
+static size_t memoriaTransposicao = MEMORIA_TRANSPOSICAO_PADRAO;
+
+void definirMemoriaTransposicao(size_t bytes) {
+    memoriaTransposicao = bytes;
+}
+
+size_t obterMemoriaTransposicao(void) {
+    return memoriaTransposicao;
+}
+
+// Memória da tabela para este tabuleiro: a configurada, mas sem passar de 512 entradas por casa,
+// para que a procura em tabuleiros pequenos não pague uma tabela grande
+static size_t memoriaTransposicaoJogo(Jogo *jogo) {
+    size_t limite = (size_t)512 * jogo->linhas * jogo->colunas * sizeof(uint64_t);
+    return memoriaTransposicao < limite ? memoriaTransposicao : limite;
+}
+
+// Devolve NULL se bytes não chega para um grupo de entradas ou se falhar a alocação
+TabelaTransposicao* criarTabelaTransposicao(size_t bytes) {
+    size_t entradas = 4;
+    if (bytes / sizeof(uint64_t) < entradas) return NULL;
+    while (entradas * 2 <= bytes / sizeof(uint64_t)) entradas *= 2;
+
+    TabelaTransposicao *tabela = malloc(sizeof(TabelaTransposicao));
+    if (!tabela) return NULL;
+    tabela->entradas = calloc(entradas, sizeof(uint64_t));
+    if (!tabela->entradas) {
+        free(tabela);
+        return NULL;
+    }
+    tabela->mascara = entradas - 1;
+    return tabela;
+}
+
+void freeTabelaTransposicao(TabelaTransposicao *tabela) {
+    if (tabela != NULL) {
+        free(tabela->entradas);
+        free(tabela);
+    }
+}
+
+// 1 se o tabuleiro com este hash já foi provado sem solução
+int consultarTransposicao(TabelaTransposicao *tabela, uint64_t hash) {
+    if (!tabela || hash == 0) return 0;
+
+    size_t grupo = hash & tabela->mascara & ~(size_t)3;
+    for (size_t k = 0; k < 4; k++) {
+        if (atomic_load_explicit(&tabela->entradas[grupo + k], memory_order_relaxed) == hash) return 1;
+    }
+    return 0;
+}
+
+void guardarTransposicao(TabelaTransposicao *tabela, uint64_t hash) {
+    if (!tabela || hash == 0) return;
+
+    size_t grupo = hash & tabela->mascara & ~(size_t)3;
+    for (size_t k = 0; k < 4; k++) {
+        uint64_t atual = atomic_load_explicit(&tabela->entradas[grupo + k], memory_order_relaxed);
+        if (atual == hash) return;
+        if (atual == 0) {
+            atomic_store_explicit(&tabela->entradas[grupo + k], hash, memory_order_relaxed);
+            return;
+        }
+    }
+    // Grupo cheio: os bits altos do hash escolhem a entrada substituída
+    atomic_store_explicit(&tabela->entradas[grupo + (hash >> 62)], hash, memory_order_relaxed);
+}
+
+// Consulta a tabela e conta o resultado nas estatísticas
+static int tabuleiroSemSolucao(Jogo *jogo, TabelaTransposicao *tabela, EstatisticasResolver *estatisticas) {
+    if (!tabela) return 0;
+
+    int encontrado = consultarTransposicao(tabela, jogo->mascaras->hash);
+    if (estatisticas) {
+        if (encontrado) estatisticas->acertosTransposicao++;
+        else estatisticas->falhasTransposicao++;
+    }
+    return encontrado;
+}
+
+
+// Aprendizagem de nogoods ============================================================================
+
+Aprendizagem* criarAprendizagem(Jogo *jogo) {
+    if (!jogo) return NULL;
+
+    // Num caminho há no máximo uma decisão por casa; o nível 0 é a raiz
+    int niveis = jogo->linhas * jogo->colunas + 1;
+    int posicoes = (jogo->linhas + 2) * jogo->largura;
+    Arena *arena = obterArena(jogo);
+    if (!arena) return NULL;
+
+    MarcaArena marca = marcarArena(arena);
+    Aprendizagem *a = reservarArena(arena, sizeof(Aprendizagem));
+    if (!a) return NULL;
+
+    a->palavras = (niveis + 63) / 64;
+    a->nivel = 0;
+    a->maxLiterais = MEMORIA_NOGOODS / sizeof(int);
+    a->numLiterais = 0;
+    a->numNogoods = 0;
+    a->descartados = 0;
+    a->arena = arena;
+    a->marca = marca;
+    a->razoes = reservarArenaZerada(arena, (size_t)posicoes * a->palavras * sizeof(Mascara));
+    a->conflitos = reservarArenaZerada(arena, (size_t)niveis * a->palavras * sizeof(Mascara));
+    a->decisoes = reservarArena(arena, niveis * sizeof(int));
+    a->literais = reservarArena(arena, a->maxLiterais * sizeof(int));
+    a->inicioNogood = reservarArena(arena, (MAX_NOGOODS + 1) * sizeof(int));
+    if (!a->razoes || !a->conflitos || !a->decisoes || !a->literais || !a->inicioNogood) {
+        freeAprendizagem(a);
+        return NULL;
+    }
+    a->inicioNogood[0] = 0;
+    return a;
+}
+
+void freeAprendizagem(Aprendizagem *aprendizagem) {
+    if (aprendizagem != NULL) voltarArena(aprendizagem->arena, aprendizagem->marca);
+}
+
+// Esquece os nogoods e as razões: os nogoods só valem para o tabuleiro de partida em que foram aprendidos
+static void reiniciarAprendizagem(Jogo *jogo, Aprendizagem *a) {
+    memset(a->razoes, 0, (size_t)(jogo->linhas + 2) * jogo->largura * a->palavras * sizeof(Mascara));
+    a->nivel = 0;
+    a->numLiterais = 0;
+    a->numNogoods = 0;
+}
+
+static Mascara* razaoCasa(Aprendizagem *a, int p) {
+    return a->razoes + (size_t)p * a->palavras;
+}
+
+static Mascara* conflitoNivel(Aprendizagem *a, int nivel) {
+    return a->conflitos + (size_t)nivel * a->palavras;
+}
+
+static void unirNiveis(Aprendizagem *a, Mascara *destino, const Mascara *origem) {
+    for (int k = 0; k < a->palavras; k++) destino[k] |= origem[k];
+}
+
+// Todos os níveis de decisão abertos (1 a a->nivel): a razão quando a regra não diz de que casas depende
+static void todosOsNiveis(Aprendizagem *a, Mascara *destino) {
+    memset(destino, 0, a->palavras * sizeof(Mascara));
+    for (int n = 1; n <= a->nivel; n++) destino[n / 64] |= 1ULL << (n % 64);
+}
+
+static int temNivel(const Mascara *conjunto, int nivel) {
+    return (conjunto[nivel / 64] >> (nivel % 64)) & 1;
+}
+
+// Guarda a razão da casa p: os níveis de 'razao', ou todos os níveis abertos se razao for NULL
+static void explicarCasa(Aprendizagem *a, int p, const Mascara *razao) {
+    if (!a) return;
+    if (razao) memcpy(razaoCasa(a, p), razao, a->palavras * sizeof(Mascara));
+    else todosOsNiveis(a, razaoCasa(a, p));
+}
+
+// Conflito do nível atual causado pelas casas p e q (p < 0: todos os níveis abertos)
+static void explicarConflito(Aprendizagem *a, int p, int q) {
+    if (!a) return;
+    Mascara *conflito = conflitoNivel(a, a->nivel);
+    if (p < 0) {
+        todosOsNiveis(a, conflito);
+        return;
+    }
+    memcpy(conflito, razaoCasa(a, p), a->palavras * sizeof(Mascara));
+    unirNiveis(a, conflito, razaoCasa(a, q));
+}
+
+// Literal de um nogood: a casa p com o valor dado (riscada ou branca)
+static int literal(int p, char valor) {
+    return 2 * p + (valor == '#');
+}
+
+// 1 se o literal é verdadeiro, 0 se é falso e -1 se a casa ainda está por decidir
+static int valorLiteral(Jogo *jogo, int lit) {
+    char celula = jogo->celulas[lit / 2];
+    if (celula >= 'a' && celula <= 'z') return -1;
+    return (celula == '#') == (lit & 1);
+}
+
+// Guarda como nogood as decisões dos níveis do conflito (que juntas não têm solução)
+static void aprenderNogood(Aprendizagem *a, const Mascara *conflito, EstatisticasResolver *estatisticas) {
+    int tamanho = 0;
+    for (int k = 0; k < a->palavras; k++) tamanho += __builtin_popcountll(conflito[k]);
+    if (tamanho == 0) return;
+
+    if (tamanho > MAX_LITERAIS_NOGOOD || a->numNogoods >= MAX_NOGOODS ||
+        a->numLiterais + tamanho > a->maxLiterais) {
+        a->descartados++;
+        return;
+    }
+
+    for (int k = 0; k < a->palavras; k++) {
+        Mascara niveis = conflito[k];
+        while (niveis) {
+            int n = k * 64 + __builtin_ctzll(niveis);
+            niveis &= niveis - 1;
+            a->literais[a->numLiterais++] = a->decisoes[n];
+        }
+    }
+    a->inicioNogood[++a->numNogoods] = a->numLiterais;
+    if (estatisticas) {
+        long memoria = (long)((a->numLiterais + a->numNogoods + 1) * sizeof(int));
+        estatisticas->nogoods++;
+        if (memoria > estatisticas->memoriaNogoods) estatisticas->memoriaNogoods = memoria;
+    }
+}
+
+// Percorre os nogoods: um com todos os literais verdadeiros é uma contradição; um com todos menos
+// um verdadeiros obriga o que falta a tomar o outro valor. Devolve as casas decididas ou CONTRADICAO.
+static int propagarNogoods(Jogo *jogo, Rasto *rasto, Aprendizagem *a, EstatisticasResolver *estatisticas) {
+    int alteracoes = 0;
+
+    for (int g = 0; g < a->numNogoods; g++) {
+        int inicio = a->inicioNogood[g], fim = a->inicioNogood[g + 1];
+        int livre = -1, satisfeito = 0;
+        for (int k = inicio; k < fim && !satisfeito; k++) {
+            int v = valorLiteral(jogo, a->literais[k]);
+            if (v == 0) satisfeito = 1;
+            else if (v < 0) {
+                if (livre >= 0) satisfeito = 1;     // Dois por decidir: ainda não diz nada
+                livre = a->literais[k];
+            }
+        }
+        if (satisfeito) continue;
+
+        // A razão é a união das razões dos literais verdadeiros
+        Mascara *razao = conflitoNivel(a, a->nivel);
+        memset(razao, 0, a->palavras * sizeof(Mascara));
+        for (int k = inicio; k < fim; k++) {
+            if (a->literais[k] != livre) unirNiveis(a, razao, razaoCasa(a, a->literais[k] / 2));
+        }
+        if (estatisticas) estatisticas->usosNogoods++;
+        if (livre < 0) return CONTRADICAO;
+
+        int p = livre / 2;
+        definirCasa(jogo, rasto, p, (livre & 1) ? toupper(jogo->celulas[p]) : '#');
+        explicarCasa(a, p, razao);
+        alteracoes++;
+    }
+
+    return alteracoes;
+}
+
+
+// Regras de propagação ===============================================================================
+
+// Regra 1: letras iguais a uma branca na mesma linha ou coluna ficam riscadas.
+// Duas brancas iguais na mesma linha ou coluna são uma contradição.
+static int propagarEliminacaoLetras(Jogo *jogo, Rasto *rasto, Aprendizagem *apr) {
+    MascarasTabuleiro *m = jogo->mascaras;
+    int alteracoes = 0;
+
+    for (int l = 0; l < NUM_LETRAS; l++) {
+        for (int i = 0; i < jogo->linhas; i++) {
+            Mascara letra = m->letraLinha[l * jogo->linhas + i];
+            Mascara brancas = letra & m->brancasLinha[i];
+            if (!brancas) continue;
+            int branca = INDICE_CELULA(jogo, i, __builtin_ctzll(brancas));
+            if (brancas & (brancas - 1)) {
+                Mascara outras = brancas & (brancas - 1);
+                explicarConflito(apr, branca, INDICE_CELULA(jogo, i, __builtin_ctzll(outras)));
+                return CONTRADICAO;
+            }
+
+            Mascara alvo = letra & m->indecisasLinha[i];
+            while (alvo) {
+                int j = __builtin_ctzll(alvo);
+                alvo &= alvo - 1;
+                definirCasa(jogo, rasto, INDICE_CELULA(jogo, i, j), '#');
+                if (apr) explicarCasa(apr, INDICE_CELULA(jogo, i, j), razaoCasa(apr, branca));
+                alteracoes++;
+            }
+        }
+
+        for (int j = 0; j < jogo->colunas; j++) {
+            Mascara letra = m->letraColuna[l * jogo->colunas + j];
+            Mascara brancas = letra & m->brancasColuna[j];
+            if (!brancas) continue;
+            int branca = INDICE_CELULA(jogo, __builtin_ctzll(brancas), j);
+            if (brancas & (brancas - 1)) {
+                Mascara outras = brancas & (brancas - 1);
+                explicarConflito(apr, branca, INDICE_CELULA(jogo, __builtin_ctzll(outras), j));
+                return CONTRADICAO;
+            }
+
+            Mascara alvo = letra & m->indecisasColuna[j];
+            while (alvo) {
+                int i = __builtin_ctzll(alvo);
+                alvo &= alvo - 1;
+                definirCasa(jogo, rasto, INDICE_CELULA(jogo, i, j), '#');
+                if (apr) explicarCasa(apr, INDICE_CELULA(jogo, i, j), razaoCasa(apr, branca));
+                alteracoes++;
+            }
+        }
+    }
+
+    return alteracoes;
+}
+
+// Regra 2: as vizinhas de uma casa riscada ficam brancas.
+// Duas casas riscadas adjacentes são uma contradição.
+static int propagarVizinhosRiscadas(Jogo *jogo, Rasto *rasto, Aprendizagem *apr) {
+    MascarasTabuleiro *m = jogo->mascaras;
+    int alteracoes = 0;
+
+    for (int i = 0; i < jogo->linhas; i++) {
+        Mascara riscadas = m->riscadasLinha[i];
+        Mascara acima = i > 0 ? m->riscadasLinha[i - 1] : 0;
+        Mascara abaixo = i + 1 < jogo->linhas ? m->riscadasLinha[i + 1] : 0;
+
+        if (riscadas & (riscadas >> 1)) {
+            int j = __builtin_ctzll(riscadas & (riscadas >> 1));
+            explicarConflito(apr, INDICE_CELULA(jogo, i, j), INDICE_CELULA(jogo, i, j + 1));
+            return CONTRADICAO;
+        }
+        if (riscadas & abaixo) {
+            int j = __builtin_ctzll(riscadas & abaixo);
+            explicarConflito(apr, INDICE_CELULA(jogo, i, j), INDICE_CELULA(jogo, i + 1, j));
+            return CONTRADICAO;
+        }
+
+        Mascara alvo = ((riscadas << 1) | (riscadas >> 1) | acima | abaixo) & m->indecisasLinha[i];
+        while (alvo) {
+            int j = __builtin_ctzll(alvo);
+            alvo &= alvo - 1;
+            int p = INDICE_CELULA(jogo, i, j);
+            definirCasa(jogo, rasto, p, toupper(jogo->tabuleiro[i][j]));
+            if (apr) {
+                // A razão é a de uma das riscadas vizinhas
+                int d = 0;
+                while (jogo->celulas[p + jogo->deslocamentos[d]] != '#') d++;
+                explicarCasa(apr, p, razaoCasa(apr, p + jogo->deslocamentos[d]));
+            }
+            alteracoes++;
+        }
+    }
+
+    return alteracoes;
+}
+
+// Regra 3: todo o ponto de articulação do grafo das casas não riscadas tem de ser branco,
+// e um grafo já desconexo é uma contradição (ver calcularPontosArticulacao).
+static int propagarConectividade(Jogo *jogo, Rasto *rasto, char *articulacao, Aprendizagem *apr) {
+    int colunas = jogo->colunas;
+    int total = jogo->linhas * colunas;
+
+    if (calcularPontosArticulacao(jogo, articulacao) < 0) {
+        explicarConflito(apr, -1, -1);
+        return CONTRADICAO;
+    }
+
+    int alteracoes = 0;
+    for (int k = 0; k < total; k++) {
+        char celula = jogo->tabuleiro[k / colunas][k % colunas];
+        if (articulacao[k] && celula >= 'a' && celula <= 'z') {
+            definirCasa(jogo, rasto, INDICE_CELULA(jogo, k / colunas, k % colunas), toupper(celula));
+            explicarCasa(apr, INDICE_CELULA(jogo, k / colunas, k % colunas), NULL);
+            alteracoes++;
+        }
+    }
+
+    return alteracoes;
+}
+
+typedef struct {
+    Rasto *rasto;
+    Aprendizagem *aprendizagem;
+} ContextoPropagacao;
+
+// Casa deduzida por uma regra da tabela. As regras que só olham para as letras valem em qualquer
+// ramo e não dependem de nenhuma decisão.
+static void decidirCasaProcura(Jogo *jogo, int linha, int coluna, char novo, IdRegra regra, void *contexto) {
+    ContextoPropagacao *c = contexto;
+    int p = INDICE_CELULA(jogo, linha, coluna);
+    definirCasa(jogo, c->rasto, p, novo);
+    if (c->aprendizagem) {
+        if (REGRAS_DEDUCAO[regra].soLetras) memset(razaoCasa(c->aprendizagem, p), 0, c->aprendizagem->palavras * sizeof(Mascara));
+        else explicarCasa(c->aprendizagem, p, NULL);
+    }
+}
+
+// Aplica as três regras, a tabela de regras extra e os nogoods aprendidos até não haver mais
+// alterações, registando-as no rasto (se existir). Para contar soluções ficam de fora as regras que
+// só valem com solução única. Com aprendizagem, cada casa decidida guarda a sua razão e uma
+// contradição deixa o conflito em conflitoNivel(apr, apr->nivel).
+// Devolve 1 se o tabuleiro continua consistente e 0 se foi encontrada uma contradição.
+static int propagar(Jogo *jogo, Rasto *rasto, EstatisticasResolver *estatisticas, int contarTodas, Aprendizagem *apr) {
+    AreaTrabalho *trabalho = obterAreaTrabalho(jogo);
+    if (!trabalho) {
+        printf("Erro na alocação de memória para a propagação.\n");
+        explicarConflito(apr, -1, -1);
+        return 0;
+    }
+    char *articulacao = trabalho->articulacao;
+    ContextoPropagacao contexto = { rasto, apr };
+
+    int consistente = 1;
+    int alteracoes;
+    do {
+        alteracoes = 0;
+
+        // A união de riscadas deteta logo uma região separada, sem percorrer o tabuleiro
+        int r = CONTRADICAO;
+        if (regiaoNaoRiscadaConexa(jogo)) r = propagarEliminacaoLetras(jogo, rasto, apr);
+        else explicarConflito(apr, -1, -1);
+        if (r != CONTRADICAO) {
+            alteracoes += r;
+            r = propagarVizinhosRiscadas(jogo, rasto, apr);
+        }
+        // A conectividade é a regra mais cara, por isso só corre quando as outras estabilizam
+        if (r != CONTRADICAO) {
+            alteracoes += r;
+            if (alteracoes == 0) {
+                r = propagarConectividade(jogo, rasto, articulacao, apr);
+                if (r != CONTRADICAO) alteracoes += r;
+            }
+            if (r != CONTRADICAO && alteracoes == 0) {
+                alteracoes = aplicarRegrasDeducao(jogo, !contarTodas, decidirCasaProcura, &contexto,
+                                                  estatisticas ? estatisticas->disparosRegras : NULL);
+            }
+            // Os nogoods só são percorridos quando todas as regras estabilizam
+            if (apr && alteracoes == 0) {
+                r = propagarNogoods(jogo, rasto, apr, estatisticas);
+                if (r != CONTRADICAO) alteracoes += r;
+            }
+        }
+
+        if (r == CONTRADICAO) {
+            consistente = 0;
+        } else if (estatisticas) {
+            estatisticas->deducoes += alteracoes;
+        }
+    } while (consistente && alteracoes > 0);
+
+    return consistente;
+}
+
+int propagarDeducoes(Jogo *jogo, EstatisticasResolver *estatisticas) {
+    if (!jogo) return 0;
+    return propagar(jogo, NULL, estatisticas, 0, NULL);
+}
+
+
+// Sondagem ============================================================================================
+
+// Número de valores experimentados por cada chamada da ajuda automática ou por cada resolução
+static int orcamentoSondagem = ORCAMENTO_SONDAGEM_PADRAO;
+
+void definirOrcamentoSondagem(int orcamento) {
+    if (orcamento >= 0) orcamentoSondagem = orcamento;
+}
+
+int obterOrcamentoSondagem(void) {
+    return orcamentoSondagem;
+}
+
+// Experimenta cada casa por decidir com branco e com riscado; cada valor propagado gasta uma
+// unidade do orçamento. Quando um dos valores leva a uma contradição, o outro é fixado com
+// 'fixar'. Devolve o número de casas fixadas, ou -1 se os dois valores de uma casa falham.
+int sondarCasas(Jogo *jogo, int *orcamento, FixarCasa fixar, void *contexto, EstatisticasResolver *estatisticas) {
+    if (!jogo || !orcamento || !fixar || *orcamento <= 0 || jogo->mascaras->indecisas == 0) return 0;
+
+    Rasto *tentativa = criarRasto(jogo);
+    if (!tentativa) {
+        printf("Erro na alocação de memória para a sondagem.\n");
+        return 0;
+    }
+
+    int fixadas = 0;
+    for (int i = 0; i < jogo->linhas && *orcamento > 0; i++) {
+        for (int j = 0; j < jogo->colunas && *orcamento > 0; j++) {
+            char celula = jogo->tabuleiro[i][j];
+            if (celula < 'a' || celula > 'z') continue;
+
+            char valores[2] = { toupper(celula), '#' };
+            int falhou[2] = { 0, 0 };
+            for (int t = 0; t < 2 && *orcamento > 0; t++) {
+                if (valores[t] == '#' && riscarSepararia(jogo, i, j)) {
+                    falhou[t] = 1;
+                    continue;
+                }
+
+                (*orcamento)--;
+                if (estatisticas) estatisticas->sondagens++;
+                abrirNivel(tentativa);
+                definirCasa(jogo, tentativa, INDICE_CELULA(jogo, i, j), valores[t]);
+                falhou[t] = !propagar(jogo, tentativa, NULL, 0, NULL);
+                voltarAoNivel(jogo, tentativa, 0);
+            }
+
+            if (falhou[0] && falhou[1]) {
+                freeRasto(tentativa);
+                return -1;
+            }
+            if (falhou[0] || falhou[1]) {
+                fixar(jogo, i, j, falhou[0] ? valores[1] : valores[0], contexto);
+                fixadas++;
+            }
+        }
+    }
+
+    freeRasto(tentativa);
+    return fixadas;
+}
+
+static void fixarCasaProcura(Jogo *jogo, int linha, int coluna, char novo, void *contexto) {
+    definirCasa(jogo, contexto, INDICE_CELULA(jogo, linha, coluna), novo);
+}
+
+// Propagação e sondagem alternadas na raiz da procura, dentro do orçamento configurado.
+// Devolve 1 se o tabuleiro continua consistente e 0 se não tem solução.
+static int sondarRaiz(Jogo *jogo, Rasto *rasto, EstatisticasResolver *estatisticas) {
+    int orcamento = orcamentoSondagem;
+
+    for (;;) {
+        if (!propagar(jogo, rasto, estatisticas, 0, NULL)) return 0;
+
+        int fixadas = sondarCasas(jogo, &orcamento, fixarCasaProcura, rasto, estatisticas);
+        if (fixadas < 0) return 0;
+        if (fixadas == 0) return 1;
+        if (estatisticas) estatisticas->deducoes += fixadas;
+    }
+}
+
+
+// Procura =============================================================================================
+
+// Guarda o tabuleiro atual (o nó depois da propagação) e o de entrada do nó como sem solução;
+// um ramo cancelado não provou nada
+static void guardarSemSolucao(Jogo *jogo, TabelaTransposicao *tabela, uint64_t entrada, atomic_int *cancelar) {
+    if (!tabela || (cancelar && atomic_load_explicit(cancelar, memory_order_relaxed))) return;
+    guardarTransposicao(tabela, entrada);
+    guardarTransposicao(tabela, jogo->mascaras->hash);
+}
+
+// Abre o nível de decisão seguinte com a casa p; a razão do valor é só esse nível
+static void abrirDecisao(Aprendizagem *apr, int decisao, int p, char valor) {
+    apr->nivel = decisao + 1;
+    apr->decisoes[apr->nivel] = literal(p, valor);
+    Mascara *razao = razaoCasa(apr, p);
+    memset(razao, 0, apr->palavras * sizeof(Mascara));
+    razao[apr->nivel / 64] = 1ULL << (apr->nivel % 64);
+}
+
+// Riscar a casa de decisão separaria a região não riscada: o conflito inclui todos os níveis
+static void conflitoSeparacao(Aprendizagem *apr, int decisao, Mascara *conflito) {
+    Mascara *todos = conflitoNivel(apr, decisao + 1);
+    todosOsNiveis(apr, todos);
+    unirNiveis(apr, conflito, todos);
+}
+
+// Trata o conflito de uma tentativa sem solução do nível decisao + 1. Se não depender da decisão,
+// passa a ser o conflito do nó e devolve 1: o outro valor falharia da mesma forma. Senão dá um
+// nogood e junta-se ao conflito do nó sem esse nível; devolve 0.
+static int analisarConflito(Aprendizagem *apr, int decisao, Mascara *conflito, EstatisticasResolver *estatisticas) {
+    apr->nivel = decisao;
+    Mascara *filho = conflitoNivel(apr, decisao + 1);
+    if (!temNivel(filho, decisao + 1)) {
+        memcpy(conflito, filho, apr->palavras * sizeof(Mascara));
+        if (estatisticas) estatisticas->saltos++;
+        return 1;
+    }
+    aprenderNogood(apr, filho, estatisticas);
+    filho[(decisao + 1) / 64] &= ~(1ULL << ((decisao + 1) % 64));
+    unirNiveis(apr, conflito, filho);
+    return 0;
+}
+
+// Procura em profundidade: propaga, escolhe uma casa por decidir e experimenta branco e depois riscado.
+// Cada tentativa abre um nível no rasto e, se falhar, volta a esse nível; não há alocações por nó.
+// Se cancelar ficar ativo (outra thread encontrou a solução), o ramo é abandonado.
+// Com aprendizagem, cada tentativa é também um nível de decisão: um conflito que não dependa da
+// decisão deste nível sobe logo (sem experimentar o outro valor) e um que dependa dá um nogood.
+// Ao falhar, o conflito do nó fica em conflitoNivel(apr, apr->nivel).
+// Os tabuleiros sem solução, antes e depois da propagação, ficam na tabela de transposição (se
+// existir), para que outra ordem de decisões que chegue ao mesmo tabuleiro pare logo.
+static int procurar(Jogo *jogo, Rasto *rasto, EstatisticasResolver *estatisticas, atomic_int *cancelar,
+                    Aprendizagem *apr, TabelaTransposicao *tabela) {
+    if (cancelar && atomic_load_explicit(cancelar, memory_order_relaxed)) return 0;
+
+    if (estatisticas) estatisticas->nos++;
+
+    // Sem saber porque falhou, o conflito de um tabuleiro da tabela inclui todos os níveis
+    uint64_t entrada = jogo->mascaras->hash;
+    if (tabuleiroSemSolucao(jogo, tabela, estatisticas)) {
+        explicarConflito(apr, -1, -1);
+        return 0;
+    }
+
+    if (!propagar(jogo, rasto, estatisticas, 0, apr)) return 0;
+
+    if (jogo->mascaras->hash != entrada && tabuleiroSemSolucao(jogo, tabela, estatisticas)) {
+        explicarConflito(apr, -1, -1);
+        return 0;
+    }
+
+    int linha, coluna;
+    char tentativas[2];
+    escolherRamificacao(jogo, &linha, &coluna, tentativas);
+
+    // Sem casas por decidir e sem contradições: a propagação garante que é uma solução
+    if (linha == -1) return 1;
+
+    int p = INDICE_CELULA(jogo, linha, coluna);
+    int decisao = apr ? apr->nivel : 0;
+    Mascara *conflito = apr ? conflitoNivel(apr, decisao) : NULL;
+    if (apr) memset(conflito, 0, apr->palavras * sizeof(Mascara));
+
+    for (int t = 0; t < 2; t++) {
+        // Riscar uma casa que separaria a região não riscada é uma contradição imediata
+        if (tentativas[t] == '#' && riscarSepararia(jogo, linha, coluna)) {
+            if (apr) conflitoSeparacao(apr, decisao, conflito);
+            continue;
+        }
+
+        int nivel = rasto->nivel;
+        abrirNivel(rasto);
+        definirCasa(jogo, rasto, p, tentativas[t]);
+        if (apr) abrirDecisao(apr, decisao, p, tentativas[t]);
+        if (procurar(jogo, rasto, estatisticas, cancelar, apr, tabela)) return 1;
+
+        if (estatisticas) estatisticas->retrocessos++;
+        voltarAoNivel(jogo, rasto, nivel);
+
+        if (apr && analisarConflito(apr, decisao, conflito, estatisticas)) break;
+    }
+
+    guardarSemSolucao(jogo, tabela, entrada, cancelar);
+    return 0;
+}
+
+// Devolve 1 se o tabuleiro ficou resolvido e 0 se este ramo não tem solução.
+int procurarSolucao(Jogo *jogo, Rasto *rasto, EstatisticasResolver *estatisticas) {
+    if (!jogo || !rasto) return 0;
+
+    // A propagação na raiz resolve muitos tabuleiros: só então vale a pena criar a aprendizagem e a
+    // tabela. Sem memória para elas a procura continua sem elas.
+    int consistente = propagar(jogo, rasto, estatisticas, 0, NULL);
+    if (!consistente || jogo->mascaras->indecisas == 0) {
+        if (estatisticas) estatisticas->nos++;      // A raiz é o único nó
+        return consistente;
+    }
+
+    Aprendizagem *apr = criarAprendizagem(jogo);
+    TabelaTransposicao *tabela = criarTabelaTransposicao(memoriaTransposicaoJogo(jogo));
+    int resultado = procurar(jogo, rasto, estatisticas, NULL, apr, tabela);
+    freeTabelaTransposicao(tabela);
+    freeAprendizagem(apr);
+    return resultado;
+}
+
+// Resolve o jogo no próprio tabuleiro, sem registar movimentos.
+// Devolve 1 com o tabuleiro resolvido, 0 se não há solução (tabuleiro intacto) e -1 em erro.
+int resolverComPropagacao(Jogo *jogo, EstatisticasResolver *estatisticas) {
+    if (!jogo) return -1;
+
+    EstatisticasResolver local = {0};
+    if (!estatisticas) estatisticas = &local;
+
+    Rasto *rasto = criarRasto(jogo);
+    if (!rasto) {
+        printf("Erro na alocação de memória para o rasto.\n");
+        return -1;
+    }
+
+    abrirNivel(rasto);
+    int resultado = sondarRaiz(jogo, rasto, estatisticas) ? procurarSolucao(jogo, rasto, estatisticas) : 0;
+    if (!resultado) voltarAoNivel(jogo, rasto, 0);
+
+    freeRasto(rasto);
+    return resultado;
+}
+
+
+
+// Contagem de soluções ================================================================================
+
+typedef struct {
+    int limite;
+    int encontradas;
+    char **guardar;     // Se não for NULL, recebe uma cópia do vetor do tabuleiro de cada solução
+    int tamanho;
+    EstatisticasResolver *estatisticas;
+    Aprendizagem *aprendizagem;     // NULL: sem nogoods nem saltos
+    TabelaTransposicao *tabela;     // NULL: sem tabela de transposição
+} ContagemSolucoes;
+
+// Como procurar, mas depois de cada solução volta atrás e continua até chegar ao limite.
+// Um ramo sem soluções foi percorrido até ao fim (o limite só pára ramos que as têm), por isso os
+// nogoods, os saltos e a tabela de transposição valem como na procura; os ramos com soluções não
+// deixam conflito.
+static void contar(Jogo *jogo, Rasto *rasto, ContagemSolucoes *contagem) {
+    EstatisticasResolver *estatisticas = contagem->estatisticas;
+    Aprendizagem *apr = contagem->aprendizagem;
+    TabelaTransposicao *tabela = contagem->tabela;
+    if (estatisticas) estatisticas->nos++;
+
+    uint64_t entrada = jogo->mascaras->hash;
+    if (tabuleiroSemSolucao(jogo, tabela, estatisticas)) {
+        explicarConflito(apr, -1, -1);
+        return;
+    }
+
+    if (!propagar(jogo, rasto, estatisticas, 1, apr)) return;
+
+    if (jogo->mascaras->hash != entrada && tabuleiroSemSolucao(jogo, tabela, estatisticas)) {
+        explicarConflito(apr, -1, -1);
+        return;
+    }
+
+    int linha, coluna;
+    char tentativas[2];
+    escolherRamificacao(jogo, &linha, &coluna, tentativas);
+
+    if (linha == -1) {
+        if (contagem->guardar) memcpy(contagem->guardar[contagem->encontradas], jogo->celulas, contagem->tamanho);
+        contagem->encontradas++;
+        return;
+    }
+
+    int p = INDICE_CELULA(jogo, linha, coluna);
+    int antes = contagem->encontradas;
+    int decisao = apr ? apr->nivel : 0;
+    Mascara *conflito = apr ? conflitoNivel(apr, decisao) : NULL;
+    if (apr) memset(conflito, 0, apr->palavras * sizeof(Mascara));
+
+    for (int t = 0; t < 2 && contagem->encontradas < contagem->limite; t++) {
+        if (tentativas[t] == '#' && riscarSepararia(jogo, linha, coluna)) {
+            if (apr) conflitoSeparacao(apr, decisao, conflito);
+            continue;
+        }
+
+        int nivel = rasto->nivel;
+        int encontradas = contagem->encontradas;
+        abrirNivel(rasto);
+        definirCasa(jogo, rasto, p, tentativas[t]);
+        if (apr) abrirDecisao(apr, decisao, p, tentativas[t]);
+        contar(jogo, rasto, contagem);
+
+        if (estatisticas) estatisticas->retrocessos++;
+        voltarAoNivel(jogo, rasto, nivel);
+
+        if (apr) {
+            apr->nivel = decisao;
+            if (contagem->encontradas == encontradas && analisarConflito(apr, decisao, conflito, estatisticas)) break;
+        }
+    }
+
+    if (contagem->encontradas == antes) guardarSemSolucao(jogo, tabela, entrada, NULL);
+}
+
+// Conta as soluções do jogo, parando ao chegar a limite; o tabuleiro fica como estava.
+// Cada guardar[k] (se guardar não for NULL) tem de ter (linhas + 2) * largura bytes.
+// Devolve o número de soluções encontradas (no máximo limite) ou -1 em erro.
+int contarSolucoes(Jogo *jogo, int limite, char **guardar, EstatisticasResolver *estatisticas) {
+    if (!jogo || limite < 1) return -1;
+
+    Rasto *rasto = criarRasto(jogo);
+    if (!rasto) {
+        printf("Erro na alocação de memória para o rasto.\n");
+        return -1;
+    }
+
+    ContagemSolucoes contagem = { limite, 0, guardar, (jogo->linhas + 2) * jogo->largura, estatisticas, NULL, NULL };
+    abrirNivel(rasto);
+
+    // Como em procurarSolucao, a aprendizagem e a tabela só são criadas se a propagação na raiz
+    // deixar casas por decidir
+    if (propagar(jogo, rasto, estatisticas, 1, NULL) && jogo->mascaras->indecisas > 0) {
+        contagem.aprendizagem = criarAprendizagem(jogo);
+        contagem.tabela = criarTabelaTransposicao(memoriaTransposicaoJogo(jogo));
+    }
+    contar(jogo, rasto, &contagem);
+    voltarAoNivel(jogo, rasto, 0);
+
+    freeTabelaTransposicao(contagem.tabela);
+    freeAprendizagem(contagem.aprendizagem);
+    freeRasto(rasto);
+    return contagem.encontradas;
+}
+
+// Procura paralela ====================================================================================
+
+// Um ramo da árvore de procura: o tabuleiro completo nesse ponto e a profundidade da decisão
+typedef struct {
+    char *celulas;
+    int profundidade;
+} Tarefa;
+
+// Fila dupla de tarefas de uma thread: a dona tira do fim, as outras roubam do início
+typedef struct {
+    Tarefa *tarefas;
+    int inicio;
+    int fim;
+    int capacidade;
+    pthread_mutex_t trinco;
+    Slab tabuleiros;    // Vetores de tabuleiro das tarefas, só usado pela thread dona (sem trinco)
+} FilaTarefas;
+
+typedef struct {
+    Jogo *base;
+    int numThreads;
+    int profundidadeDivisao;    // Até esta profundidade cada ramo é dividido em tarefas
+    int tamanho;                // Bytes do vetor do tabuleiro
+    FilaTarefas *filas;
+    atomic_int pendentes;       // Tarefas criadas e ainda não terminadas
+    atomic_int terminado;       // Solução encontrada ou erro: as threads param
+    int erro;
+    char *solucao;
+    EstatisticasResolver estatisticas;
+    TabelaTransposicao *transposicao;   // Partilhada pelas threads (NULL: sem tabela)
+    pthread_mutex_t trinco;     // Protege solucao, erro e estatisticas
+} ProcuraParalela;
+
+typedef struct {
+    ProcuraParalela *procura;
+    int id;
+} ArgumentoThread;
+
+static int colocarTarefa(FilaTarefas *fila, Tarefa tarefa) {
+    pthread_mutex_lock(&fila->trinco);
+    if (fila->fim == fila->capacidade) {
+        // Reaproveitar o espaço já roubado antes de crescer
+        if (fila->inicio > 0) {
+            memmove(fila->tarefas, fila->tarefas + fila->inicio, (fila->fim - fila->inicio) * sizeof(Tarefa));
+            fila->fim -= fila->inicio;
+            fila->inicio = 0;
+        } else {
+            int capacidade = fila->capacidade ? fila->capacidade * 2 : 16;
+            Tarefa *tarefas = realloc(fila->tarefas, capacidade * sizeof(Tarefa));
+            if (!tarefas) {
+                pthread_mutex_unlock(&fila->trinco);
+                return -1;
+            }
+            fila->tarefas = tarefas;
+            fila->capacidade = capacidade;
+        }
+    }
+    fila->tarefas[fila->fim++] = tarefa;
+    pthread_mutex_unlock(&fila->trinco);
+    return 0;
+}
+
+// Tira uma tarefa do fim (a mais profunda, para a própria thread) ou do início (a mais rasa, para roubar)
+static int tirarTarefa(FilaTarefas *fila, Tarefa *tarefa, int roubar) {
+    int sucesso = 0;
+    pthread_mutex_lock(&fila->trinco);
+    if (fila->inicio < fila->fim) {
+        *tarefa = roubar ? fila->tarefas[fila->inicio++] : fila->tarefas[--fila->fim];
+        if (fila->inicio == fila->fim) fila->inicio = fila->fim = 0;
+        sucesso = 1;
+    }
+    pthread_mutex_unlock(&fila->trinco);
+    return sucesso;
+}
+
+static void registarSolucao(ProcuraParalela *procura, Jogo *jogo) {
+    pthread_mutex_lock(&procura->trinco);
+    if (!atomic_load(&procura->terminado)) {
+        memcpy(procura->solucao, jogo->celulas, procura->tamanho);
+        atomic_store(&procura->terminado, 1);
+    }
+    pthread_mutex_unlock(&procura->trinco);
+}
+
+static void registarErro(ProcuraParalela *procura) {
+    pthread_mutex_lock(&procura->trinco);
+    procura->erro = 1;
+    atomic_store(&procura->terminado, 1);
+    pthread_mutex_unlock(&procura->trinco);
+}
+
+// Põe o tabuleiro da thread no estado da tarefa, alterando só as casas diferentes
+static void carregarTarefa(Jogo *jogo, const char *celulas) {
+    for (int i = 0; i < jogo->linhas; i++) {
+        for (int j = 0; j < jogo->colunas; j++) {
+            char valor = celulas[INDICE_CELULA(jogo, i, j)];
+            if (jogo->tabuleiro[i][j] != valor) alterarCelula(jogo, i, j, valor);
+        }
+    }
+}
+
+// Cria a tarefa do ramo em que a casa (linha, coluna) toma o valor dado
+static int criarTarefaFilha(ProcuraParalela *procura, FilaTarefas *fila, Jogo *jogo,
+                            int linha, int coluna, char valor, int profundidade) {
+    char anterior = jogo->tabuleiro[linha][coluna];
+    Tarefa filha = { reservarSlab(&fila->tabuleiros), profundidade };
+    if (!filha.celulas) return -1;
+
+    alterarCelula(jogo, linha, coluna, valor);
+    memcpy(filha.celulas, jogo->celulas, procura->tamanho);
+    alterarCelula(jogo, linha, coluna, anterior);
+
+    atomic_fetch_add(&procura->pendentes, 1);
+    if (colocarTarefa(fila, filha) != 0) {
+        atomic_fetch_sub(&procura->pendentes, 1);
+        devolverSlab(&fila->tabuleiros, filha.celulas);
+        return -1;
+    }
+    return 0;
+}
+
+// Trata uma tarefa: perto da raiz divide-a em duas tarefas filhas, mais abaixo resolve-a sequencialmente
+static void processarTarefa(ProcuraParalela *procura, FilaTarefas *fila, Jogo *jogo, Rasto *rasto,
+                            Aprendizagem *apr, Tarefa *tarefa, EstatisticasResolver *estatisticas) {
+    carregarTarefa(jogo, tarefa->celulas);
+
+    if (tarefa->profundidade >= procura->profundidadeDivisao) {
+        rasto->topo = 0;
+        rasto->nivel = 0;
+        abrirNivel(rasto);
+        if (apr) reiniciarAprendizagem(jogo, apr);
+        if (procurar(jogo, rasto, estatisticas, &procura->terminado, apr, procura->transposicao)) registarSolucao(procura, jogo);
+        return;
+    }
+
+    estatisticas->nos++;
+    if (!propagar(jogo, NULL, estatisticas, 0, NULL)) {
+        estatisticas->retrocessos++;
+        return;
+    }
+
+    int linha, coluna;
+    char tentativas[2];
+    escolherRamificacao(jogo, &linha, &coluna, tentativas);
+
+    if (linha == -1) {
+        registarSolucao(procura, jogo);
+        return;
+    }
+
+    // O segundo ramo entra primeiro para que a própria thread continue pelo primeiro, como a procura sequencial
+    int profundidade = tarefa->profundidade + 1;
+    int falhou = 0;
+    for (int t = 1; t >= 0; t--) {
+        if (tentativas[t] == '#' && riscarSepararia(jogo, linha, coluna)) continue;
+        falhou |= criarTarefaFilha(procura, fila, jogo, linha, coluna, tentativas[t], profundidade);
+    }
+    if (falhou) registarErro(procura);
+}
+
+static void* trabalhador(void *argumento) {
+    ArgumentoThread *arg = argumento;
+    ProcuraParalela *procura = arg->procura;
+    FilaTarefas *propria = &procura->filas[arg->id];
+    EstatisticasResolver estatisticas = {0};
+
+    // Cada thread trabalha na sua cópia do jogo, com máscaras e união próprias
+    Jogo *jogo = copiarJogo(procura->base);
+    Rasto *rasto = jogo ? criarRasto(jogo) : NULL;
+    if (!rasto) registarErro(procura);
+    Aprendizagem *apr = jogo ? criarAprendizagem(jogo) : NULL;
+
+    while (!atomic_load(&procura->terminado) && atomic_load(&procura->pendentes) > 0) {
+        Tarefa tarefa;
+        int obtida = tirarTarefa(propria, &tarefa, 0);
+        for (int k = 1; !obtida && k < procura->numThreads; k++) {
+            obtida = tirarTarefa(&procura->filas[(arg->id + k) % procura->numThreads], &tarefa, 1);
+        }
+
+        if (!obtida) {
+            sched_yield();
+            continue;
+        }
+
+        if (rasto && !atomic_load(&procura->terminado)) {
+            processarTarefa(procura, propria, jogo, rasto, apr, &tarefa, &estatisticas);
+        }
+        // A tarefa pode ter sido roubada: o vetor passa para o slab desta thread
+        devolverSlab(&propria->tabuleiros, tarefa.celulas);
+        atomic_fetch_sub(&procura->pendentes, 1);
+    }
+
+    pthread_mutex_lock(&procura->trinco);
+    procura->estatisticas.nos += estatisticas.nos;
+    procura->estatisticas.retrocessos += estatisticas.retrocessos;
+    procura->estatisticas.deducoes += estatisticas.deducoes;
+    procura->estatisticas.sondagens += estatisticas.sondagens;
+    for (int r = 0; r < NUM_REGRAS; r++) procura->estatisticas.disparosRegras[r] += estatisticas.disparosRegras[r];
+    procura->estatisticas.nogoods += estatisticas.nogoods;
+    procura->estatisticas.usosNogoods += estatisticas.usosNogoods;
+    procura->estatisticas.saltos += estatisticas.saltos;
+    if (estatisticas.memoriaNogoods > procura->estatisticas.memoriaNogoods) procura->estatisticas.memoriaNogoods = estatisticas.memoriaNogoods;
+    procura->estatisticas.acertosTransposicao += estatisticas.acertosTransposicao;
+    procura->estatisticas.falhasTransposicao += estatisticas.falhasTransposicao;
+    pthread_mutex_unlock(&procura->trinco);
+
+    freeAprendizagem(apr);
+    freeRasto(rasto);
+    freeJogo(jogo);
+    return NULL;
+}
+
+// Resolve o jogo no próprio tabuleiro com numThreads threads, que roubam ramos umas às outras.
+// A primeira solução encontrada cancela as restantes threads; com solução única o resultado é
+// igual ao da procura sequencial. Devolve 1 resolvido, 0 sem solução (tabuleiro intacto), -1 em erro.
+int resolverParalelo(Jogo *jogo, int numThreads, EstatisticasResolver *estatisticas) {
+    if (!jogo) return -1;
+    if (numThreads <= 1) return resolverComPropagacao(jogo, estatisticas);
+    if (numThreads > MAX_THREADS) numThreads = MAX_THREADS;
+
+    // A sondagem é feita uma vez na raiz, antes de dividir; o tabuleiro é reposto depois de copiado
+    Rasto *rastoRaiz = criarRasto(jogo);
+    if (!rastoRaiz) {
+        printf("Erro na alocação de memória para o rasto.\n");
+        return -1;
+    }
+    abrirNivel(rastoRaiz);
+    if (!sondarRaiz(jogo, rastoRaiz, estatisticas)) {
+        voltarAoNivel(jogo, rastoRaiz, 0);
+        freeRasto(rastoRaiz);
+        return 0;
+    }
+
+    ProcuraParalela procura;
+    procura.base = jogo;
+    procura.numThreads = numThreads;
+    procura.tamanho = (jogo->linhas + 2) * jogo->largura;
+    procura.erro = 0;
+    procura.estatisticas = (EstatisticasResolver){0};
+    procura.transposicao = criarTabelaTransposicao(memoriaTransposicaoJogo(jogo));
+    atomic_init(&procura.pendentes, 1);
+    atomic_init(&procura.terminado, 0);
+
+    // Dividir até haver umas dezenas de tarefas por thread para o roubo equilibrar a carga
+    procura.profundidadeDivisao = 4;
+    for (int n = 1; n < numThreads; n *= 2) procura.profundidadeDivisao++;
+
+    procura.filas = calloc(numThreads, sizeof(FilaTarefas));
+    procura.solucao = malloc(procura.tamanho);
+    for (int t = 0; procura.filas && t < numThreads; t++) iniciarSlab(&procura.filas[t].tabuleiros, procura.tamanho, 0);
+    Tarefa raiz = { procura.filas ? reservarSlab(&procura.filas[0].tabuleiros) : NULL, 0 };
+    if (!procura.filas || !procura.solucao || !raiz.celulas) {
+        printf("Erro na alocação de memória para a procura paralela.\n");
+        if (procura.filas) libertarSlab(&procura.filas[0].tabuleiros);
+        free(procura.filas);
+        free(procura.solucao);
+        freeTabelaTransposicao(procura.transposicao);
+        voltarAoNivel(jogo, rastoRaiz, 0);
+        freeRasto(rastoRaiz);
+        return -1;
+    }
+    memcpy(raiz.celulas, jogo->celulas, procura.tamanho);
+    voltarAoNivel(jogo, rastoRaiz, 0);
+    freeRasto(rastoRaiz);
+    pthread_mutex_init(&procura.trinco, NULL);
+    for (int t = 0; t < numThreads; t++) pthread_mutex_init(&procura.filas[t].trinco, NULL);
+    colocarTarefa(&procura.filas[0], raiz);
+
+    pthread_t threads[MAX_THREADS];
+    ArgumentoThread argumentos[MAX_THREADS];
+    int criadas = 0;
+    for (int t = 0; t < numThreads; t++) {
+        argumentos[t].procura = &procura;
+        argumentos[t].id = t;
+        if (pthread_create(&threads[t], NULL, trabalhador, &argumentos[t]) != 0) break;
+        criadas++;
+    }
+    if (criadas == 0) {
+        // Sem threads, a tarefa raiz nunca seria tratada
+        printf("Erro ao criar threads para a procura paralela.\n");
+        procura.erro = 1;
+    }
+    for (int t = 0; t < criadas; t++) pthread_join(threads[t], NULL);
+
+    int resultado;
+    if (procura.erro) {
+        resultado = -1;
+    } else if (atomic_load(&procura.terminado)) {
+        carregarTarefa(jogo, procura.solucao);
+        resultado = 1;
+    } else {
+        resultado = 0;
+    }
+
+    // Os slabs libertam de uma vez todas as tarefas, incluindo as que ficaram por tratar depois do cancelamento
+    long memoriaTarefas = 0;
+    for (int t = 0; t < numThreads; t++) {
+        memoriaTarefas += procura.filas[t].tabuleiros.arena.estatisticas.total;
+        libertarSlab(&procura.filas[t].tabuleiros);
+        free(procura.filas[t].tarefas);
+        pthread_mutex_destroy(&procura.filas[t].trinco);
+    }
+    pthread_mutex_destroy(&procura.trinco);
+    free(procura.filas);
+    free(procura.solucao);
+    freeTabelaTransposicao(procura.transposicao);
+
+    if (estatisticas) {
+        estatisticas->nos += procura.estatisticas.nos;
+        estatisticas->retrocessos += procura.estatisticas.retrocessos;
+        estatisticas->deducoes += procura.estatisticas.deducoes;
+        estatisticas->sondagens += procura.estatisticas.sondagens;
+        for (int r = 0; r < NUM_REGRAS; r++) estatisticas->disparosRegras[r] += procura.estatisticas.disparosRegras[r];
+        estatisticas->nogoods += procura.estatisticas.nogoods;
+        estatisticas->usosNogoods += procura.estatisticas.usosNogoods;
+        estatisticas->saltos += procura.estatisticas.saltos;
+        if (procura.estatisticas.memoriaNogoods > estatisticas->memoriaNogoods) estatisticas->memoriaNogoods = procura.estatisticas.memoriaNogoods;
+        estatisticas->acertosTransposicao += procura.estatisticas.acertosTransposicao;
+        estatisticas->falhasTransposicao += procura.estatisticas.falhasTransposicao;
+        estatisticas->memoriaTarefas += memoriaTarefas;
+    }
+    return resultado;
+}
@@ -1,14 +1,26 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <CUnit/Basic.h>
 #include <CUnit/CUnit.h>
 #include "../include/jogo.h"
+#include "../include/resolver.h"
+#include "../include/regras.h"
+#include "../include/lote.h"
+#include "../include/gerador.h"
+#include <unistd.h>
+#include <sys/stat.h>
 
 // Definições para facilitar os testes
 #define TABULEIRO_TEST "tabuleiro_test.txt"
 #define ARQUIVO_INEXISTENTE "arquivo_inexistente.txt"
 #define TABULEIRO_AJUDA_TEST "tabuleiro_ajuda_test.txt"
 #define TABULEIRO_RESOLVER_TEST "tabuleiro_resolver_test.txt"
+#define TABULEIRO_CONTRADICAO_TEST "tabuleiro_contradicao_test.txt"
+#define TABULEIRO_ARTICULACAO_TEST "tabuleiro_articulacao_test.txt"
+#define LISTA_LOTE_TEST "lista_lote_test.txt"
+#define SAIDA_LOTE_TEST "saida_lote_test"
+#define PASTA_LOTE_TEST "pasta_lote_test"
 
 // Função para criar um arquivo de teste
 void criar_arquivo_teste() {
@@ -63,6 +75,27 @@ void teste_carregar_jogo_valido() {
     limpar_arquivo_teste();
 }
 
+// Ficheiros antigos marcam os grupos do comando 'A' com "-1 -1 A": a marca é saltada e não
+// apaga os movimentos mais antigos
+void teste_carregar_jogo_marca_antiga() {
+    FILE *file = fopen(TABULEIRO_TEST, "w");
+    if (file) {
+        fprintf(file, "2 2\nAb\nbA\n3\n1 1 a\n-1 -1 A\n0 0 a\n");
+        fclose(file);
+    }
+    
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    CU_ASSERT_PTR_NOT_NULL(jogo);
+    if (jogo) {
+        CU_ASSERT_EQUAL(numeroMovimentos(jogo), 2);
+        CU_ASSERT_EQUAL(reporTabuleiroInicial(jogo), 2);
+        CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "ab");
+        CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[1], "ba");
+        freeJogo(jogo);
+    }
+    limpar_arquivo_teste();
+}
+
 void teste_carregar_jogo_arquivo_inexistente() {
     Jogo *jogo = carregarJogo(ARQUIVO_INEXISTENTE);
     CU_ASSERT_PTR_NULL(jogo);
@@ -120,6 +153,30 @@ void teste_riscar_invalido() {
     limpar_arquivo_teste();
 }
 
+// ===== Testes para o tabuleiro contíguo =====
+
+void teste_copiar_jogo_tabuleiro_contiguo() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    Jogo *copia = copiarJogo(jogo);
+    
+    CU_ASSERT_PTR_NOT_NULL(copia);
+    
+    // As linhas são vistas consecutivas do mesmo vetor e continuam a ser strings
+    CU_ASSERT(jogo->tabuleiro[1] == jogo->tabuleiro[0] + jogo->largura);
+    CU_ASSERT_STRING_EQUAL(copia->tabuleiro[0], "ecadc");
+    CU_ASSERT_STRING_EQUAL(copia->tabuleiro[4], "accbb");
+    
+    // A cópia é independente do original
+    riscar(copia, "a1");
+    CU_ASSERT_EQUAL(copia->tabuleiro[0][0], '#');
+    CU_ASSERT_EQUAL(jogo->tabuleiro[0][0], 'e');
+    
+    freeJogo(copia);
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
 // ===== Testes para registo de movimentos =====
 
 void teste_registar_movimento() {
@@ -129,10 +186,10 @@ void teste_registar_movimento() {
     char estadoAnterior = jogo->tabuleiro[0][0];
     registarMovimento(jogo, 0, 0, estadoAnterior);
     
-    CU_ASSERT_PTR_NOT_NULL(jogo->historicoMovimentos);
-    CU_ASSERT_EQUAL(jogo->historicoMovimentos->linha, 0);
-    CU_ASSERT_EQUAL(jogo->historicoMovimentos->coluna, 0);
-    CU_ASSERT_EQUAL(jogo->historicoMovimentos->estadoAnterior, estadoAnterior);
+    CU_ASSERT_PTR_NOT_NULL(ultimoMovimento(jogo));
+    CU_ASSERT_EQUAL(ultimoMovimento(jogo)->linha, 0);
+    CU_ASSERT_EQUAL(ultimoMovimento(jogo)->coluna, 0);
+    CU_ASSERT_EQUAL(ultimoMovimento(jogo)->estadoAnterior, estadoAnterior);
     
     freeJogo(jogo);
     limpar_arquivo_teste();
@@ -171,6 +228,167 @@ void teste_desfazer_movimento_sem_historico() {
     limpar_arquivo_teste();
 }
 
+void teste_desfazer_grupo_movimentos() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    CU_ASSERT_EQUAL(sizeof(Movimento), 4);
+    
+    pintarBranco(jogo, "a1");
+    iniciarAgrupamentoMovimentos(jogo);
+    pintarBranco(jogo, "b1");
+    riscar(jogo, "c1");
+    pintarBranco(jogo, "d1");
+    finalizarAgrupamentoMovimentos(jogo);
+    CU_ASSERT_EQUAL(numeroMovimentos(jogo), 4);
+    CU_ASSERT_EQUAL(ultimoMovimento(jogo)->grupo, MOVIMENTO_GRUPO);
+    CU_ASSERT_EQUAL(jogo->historico.movimentos[1].grupo, MOVIMENTO_INICIO_GRUPO);
+    
+    // O grupo é desfeito de uma vez, sem tocar no movimento anterior
+    CU_ASSERT_EQUAL(desfazerMovimento(jogo), 0);
+    CU_ASSERT_EQUAL(numeroMovimentos(jogo), 1);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "Ecadc");
+    
+    CU_ASSERT_EQUAL(desfazerMovimento(jogo), 0);
+    CU_ASSERT_EQUAL(numeroMovimentos(jogo), 0);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "ecadc");
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+void teste_refazer_movimentos() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    pintarBranco(jogo, "a1");
+    riscar(jogo, "b1");
+    iniciarAgrupamentoMovimentos(jogo);
+    pintarBranco(jogo, "c2");
+    pintarBranco(jogo, "d2");
+    finalizarAgrupamentoMovimentos(jogo);
+    
+    // O grupo é desfeito e refeito de uma vez
+    desfazerMovimento(jogo);
+    CU_ASSERT_EQUAL(numeroMovimentos(jogo), 2);
+    CU_ASSERT_EQUAL(refazerMovimento(jogo), 0);
+    CU_ASSERT_EQUAL(numeroMovimentos(jogo), 4);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[1], "dcDEc");
+    CU_ASSERT_EQUAL(refazerMovimento(jogo), -1);
+    
+    desfazerMovimento(jogo);
+    desfazerMovimento(jogo);
+    CU_ASSERT_EQUAL(refazerMovimento(jogo), 0);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "E#adc");
+    
+    // Um movimento novo apaga os que podiam ser refeitos
+    pintarBranco(jogo, "e1");
+    CU_ASSERT_EQUAL(jogo->historico.fim, 3);
+    CU_ASSERT_EQUAL(refazerMovimento(jogo), -1);
+    
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "d 3"), 0);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "ecadc");
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "f 2"), 0);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "E#adc");
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "i 3"), 0);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "E#adC");
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "i 4"), -1);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "d x"), -1);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "f 2147483647"), -1);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "d 4"), -1);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "E#adC");
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+// Guarda as 25 casas do tabuleiro de teste
+static void guardarCasas(Jogo *jogo, char *casas) {
+    for (int i = 0; i < 5; i++) memcpy(casas + 5 * i, jogo->tabuleiro[i], 5);
+}
+
+void teste_ir_para_movimento_com_pontos() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    // Mais de três intervalos de movimentos, com retrocessos pelo meio
+    enum { TOTAL = 3 * INTERVALO_PONTOS + 50 };
+    char (*estados)[25] = malloc((TOTAL + 1) * sizeof(*estados));
+    guardarCasas(jogo, estados[0]);
+    for (int t = 0; numeroMovimentos(jogo) < TOTAL; t++) {
+        char coordenada[3] = { 'a' + (t * 7) % 5, '1' + (t * 3) % 5, '\0' };
+        if (t % 11 == 10) desfazerMovimento(jogo);
+        else if (t % 3 == 0) riscar(jogo, coordenada);
+        else pintarBranco(jogo, coordenada);
+        guardarCasas(jogo, estados[numeroMovimentos(jogo)]);
+    }
+    CU_ASSERT(jogo->historico.numPontos >= 3);
+    
+    int alvos[] = { 0, TOTAL, 1, 2 * INTERVALO_PONTOS + 7, INTERVALO_PONTOS, 5, TOTAL - 1, INTERVALO_PONTOS - 1 };
+    for (int a = 0; a < (int)(sizeof(alvos) / sizeof(alvos[0])); a++) {
+        CU_ASSERT_EQUAL(irParaMovimento(jogo, alvos[a]), 0);
+        CU_ASSERT_EQUAL(numeroMovimentos(jogo), alvos[a]);
+        char casas[25];
+        guardarCasas(jogo, casas);
+        CU_ASSERT_EQUAL(memcmp(casas, estados[alvos[a]], 25), 0);
+    }
+    
+    // As máscaras acompanham os saltos
+    MascarasTabuleiro *refeitas = criarMascaras(jogo);
+    CU_ASSERT_EQUAL(refeitas->hash, jogo->mascaras->hash);
+    CU_ASSERT_EQUAL(refeitas->indecisas, jogo->mascaras->indecisas);
+    freeMascaras(refeitas);
+    
+    // Um jogo gravado e carregado volta a ter os pontos e chega aos mesmos estados
+    CU_ASSERT_EQUAL(irParaMovimento(jogo, TOTAL), 0);
+    CU_ASSERT_EQUAL(gravarJogo(jogo, "jogo_salvo.txt"), 0);
+    Jogo *carregado = carregarJogo("jogo_salvo.txt");
+    CU_ASSERT_PTR_NOT_NULL(carregado);
+    if (carregado) {
+        CU_ASSERT_EQUAL(carregado->historico.numPontos, jogo->historico.numPontos);
+        CU_ASSERT_EQUAL(irParaMovimento(carregado, INTERVALO_PONTOS + 3), 0);
+        char casas[25];
+        guardarCasas(carregado, casas);
+        CU_ASSERT_EQUAL(memcmp(casas, estados[INTERVALO_PONTOS + 3], 25), 0);
+        freeJogo(carregado);
+    }
+    remove("jogo_salvo.txt");
+    
+    free(estados);
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+void teste_ir_para_movimento_depois_de_resolver() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    // A resolução repõe o tabuleiro inicial (um grupo) e regista a solução com o tabuleiro já resolvido
+    pintarBranco(jogo, "e5");
+    CU_ASSERT_EQUAL(resolverJogo(jogo), 0);
+    int total = numeroMovimentos(jogo);
+    char resolvido[25];
+    guardarCasas(jogo, resolvido);
+    
+    CU_ASSERT_EQUAL(irParaMovimento(jogo, 2), 0);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "ecadc");
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[4], "accbb");
+    CU_ASSERT_EQUAL(irParaMovimento(jogo, 1), 0);
+    CU_ASSERT_EQUAL(jogo->tabuleiro[4][4], 'B');
+    
+    // Refazer a reposição e depois a solução, movimento a movimento
+    CU_ASSERT_EQUAL(refazerMovimento(jogo), 0);
+    CU_ASSERT_EQUAL(jogo->tabuleiro[4][4], 'b');
+    while (refazerMovimento(jogo) == 0);
+    CU_ASSERT_EQUAL(numeroMovimentos(jogo), total);
+    char casas[25];
+    guardarCasas(jogo, casas);
+    CU_ASSERT_EQUAL(memcmp(casas, resolvido, 25), 0);
+    CU_ASSERT_EQUAL(verificarVitoria(jogo), 1);
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
 void teste_desfazer_multiplos_movimentos() {
     criar_arquivo_teste();
     Jogo *jogo = carregarJogo(TABULEIRO_TEST);
@@ -353,6 +571,30 @@ void teste_verificar_restricao_vizinhos_riscados_tres_riscados() {
     limpar_arquivo_teste();
 }
 
+// ===== Testes para as máscaras do tabuleiro =====
+
+void teste_mascaras_sincronizadas() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    // Linha 1: e c a d c
+    pintarBranco(jogo, "b1");
+    CU_ASSERT_EQUAL(existeOutraBrancaNaLinha(jogo, 0, 4, 'c'), 1);
+    CU_ASSERT_EQUAL(jogo->mascaras->brancasLinha[0], (Mascara)1 << 1);
+    
+    riscar(jogo, "b1");
+    CU_ASSERT_EQUAL(existeOutraBrancaNaLinha(jogo, 0, 4, 'c'), 0);
+    CU_ASSERT_EQUAL(jogo->mascaras->riscadasColuna[1], (Mascara)1 << 0);
+    
+    desfazerMovimento(jogo);
+    CU_ASSERT_EQUAL(existeOutraBrancaNaLinha(jogo, 0, 4, 'c'), 1);
+    CU_ASSERT_EQUAL(existeOutraBrancaNaColuna(jogo, 0, 1, 'c'), 0);
+    CU_ASSERT_EQUAL(jogo->mascaras->riscadasColuna[1], 0);
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
 // ===== Testes para verificar conectividade =====
 
 void teste_verificar_conectividade_sem_brancas() {
@@ -460,6 +702,49 @@ void teste_verificar_conectividade_com_brancas_desconectadas_e_conectadas() {
 }
 
 
+void teste_uniao_riscadas_separacao() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    riscar(jogo, "a2");
+    CU_ASSERT_EQUAL(regiaoNaoRiscadaConexa(jogo), 1);
+    
+    // Riscar b1 isolaria a1 no canto
+    CU_ASSERT_EQUAL(riscarSepararia(jogo, 0, 1), 1);
+    CU_ASSERT_EQUAL(riscarSepararia(jogo, 0, 2), 0);
+    
+    riscar(jogo, "b1");
+    CU_ASSERT_EQUAL(regiaoNaoRiscadaConexa(jogo), 0);
+    
+    desfazerMovimento(jogo);
+    CU_ASSERT_EQUAL(regiaoNaoRiscadaConexa(jogo), 1);
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+void teste_conectividade_reutiliza_area_trabalho() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    pintarBranco(jogo, "a1");
+    pintarBranco(jogo, "c1");
+    CU_ASSERT_EQUAL(verificarConectividadeBrancas(jogo), -1);
+    
+    AreaTrabalho *trabalho = jogo->trabalho;
+    CU_ASSERT_PTR_NOT_NULL(trabalho);
+    
+    pintarBranco(jogo, "b1");
+    CU_ASSERT_EQUAL(verificarConectividadeBrancas(jogo), 0);
+    
+    // A segunda chamada usa a mesma área de trabalho
+    CU_ASSERT(jogo->trabalho == trabalho);
+    CU_ASSERT_EQUAL(trabalho->chamadasConectividade, 2);
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
 // ===== Testes para o comando de ajuda (a) =====
 void teste_comando_ajuda() {
     criar_arquivo_ajuda();
@@ -497,6 +782,57 @@ void teste_comando_ajuda() {
     freeJogo(jogo);
 }
 
+// ===== Teste para a regra 3 da ajuda (pontos de articulação) =====
+void teste_ajuda_pontos_articulacao() {
+    FILE *file = fopen(TABULEIRO_ARTICULACAO_TEST, "w");
+    if (file) {
+        // Riscar b1 separaria a1 de c1, logo b1 tem de ser branca
+        fprintf(file, "1 3\nabc\n");
+        fclose(file);
+    }
+    Jogo *jogo = carregarJogo(TABULEIRO_ARTICULACAO_TEST);
+    CU_ASSERT_PTR_NOT_NULL(jogo);
+    
+    char articulacao[3];
+    CU_ASSERT_EQUAL(calcularPontosArticulacao(jogo, articulacao), 1);
+    CU_ASSERT_EQUAL(articulacao[1], 1);
+    
+    int resultado = ajudar(jogo);
+    CU_ASSERT_EQUAL(resultado, 1);
+    CU_ASSERT_EQUAL(jogo->tabuleiro[0][0], 'a');
+    CU_ASSERT_EQUAL(jogo->tabuleiro[0][1], 'B');
+    CU_ASSERT_EQUAL(jogo->tabuleiro[0][2], 'c');
+    
+    freeJogo(jogo);
+    remove(TABULEIRO_ARTICULACAO_TEST);
+}
+
+// A ajuda decide casas em colunas para lá da letra 'z' (até MAX_DIMENSAO colunas)
+void teste_ajudar_colunas_largas() {
+    char casas[2 * 40 + 1];
+    memset(casas, 'd', 2 * 40);
+    casas[80] = '\0';
+    casas[0] = 'A';
+    memset(casas + 1, 'b', 34);
+    casas[35] = 'a';
+    memset(casas + 36, 'c', 4);
+    Jogo *jogo = criarJogo(2, 40, casas);
+    CU_ASSERT_PTR_NOT_NULL(jogo);
+    if (!jogo) return;
+    
+    // Regra 1: a cópia de 'A' na coluna 36 é riscada
+    CU_ASSERT_EQUAL(ajudar(jogo), 1);
+    CU_ASSERT_EQUAL(jogo->tabuleiro[0][35], '#');
+    
+    // Regra 2: os vizinhos da riscada ficam brancos
+    CU_ASSERT_EQUAL(ajudar(jogo), 3);
+    CU_ASSERT_EQUAL(jogo->tabuleiro[0][34], 'B');
+    CU_ASSERT_EQUAL(jogo->tabuleiro[0][36], 'C');
+    CU_ASSERT_EQUAL(jogo->tabuleiro[1][35], 'D');
+    
+    freeJogo(jogo);
+}
+
 // ===== Testes para o modo de ajuda automática (A) =====
 void teste_modo_ajuda_automatica() {
     criar_arquivo_teste();
@@ -522,6 +858,185 @@ void teste_modo_ajuda_automatica() {
     freeJogo(jogo);
 }
 
+// Aplica 'ajudar' até não haver alterações, como fazia o comando A antes da fila de trabalho
+static void ajudarAteEstabilizar(Jogo *jogo) {
+    while (ajudar(jogo) > 0 && !verificarVitoria(jogo));
+}
+
+static int mesmoTabuleiro(Jogo *a, Jogo *b) {
+    for (int i = 0; i < a->linhas; i++) {
+        if (strcmp(a->tabuleiro[i], b->tabuleiro[i]) != 0) return 0;
+    }
+    return 1;
+}
+
+void teste_ajuda_automatica_igual_ajudar() {
+    ParametrosGerador parametros = {7, 7, 40, 1};
+    uint64_t estado = 777;
+    int orcamento = obterOrcamentoSondagem();
+    
+    // 'ajudar' não faz sondagem: compara-se só o ponto fixo das regras
+    definirOrcamentoSondagem(0);
+    
+    // Tabuleiros com solução única e tabuleiros com jogadas já feitas, algumas contraditórias
+    const char *tabuleiros[] = {
+        "ecadcdcdecbddcbadbcebeeba", "EcadcdcdecbddcbadbcebeebA",
+        "a#aAbbAcb#cAbaBcaBbcAaa#b", "Aa#Bbab#Aa#bbbAaBa#bAAa#a"
+    };
+    for (int k = 0; k < 4; k++) {
+        Jogo *antigo = criarJogo(5, 5, tabuleiros[k]);
+        Jogo *novo = criarJogo(5, 5, tabuleiros[k]);
+        ajudarAteEstabilizar(antigo);
+        ajudaAutomatica(novo, NULL, NULL);
+        CU_ASSERT(mesmoTabuleiro(antigo, novo));
+        freeJogo(antigo);
+        freeJogo(novo);
+    }
+    for (int k = 0; k < 4; k++) {
+        Jogo *gerado = gerarJogoUnico(&parametros, &estado);
+        CU_ASSERT_PTR_NOT_NULL(gerado);
+        if (!gerado) continue;
+        
+        char casas[49];
+        for (int i = 0; i < 7; i++) memcpy(casas + i * 7, gerado->tabuleiro[i], 7);
+        Jogo *antigo = criarJogo(7, 7, casas);
+        ajudarAteEstabilizar(antigo);
+        ajudaAutomatica(gerado, NULL, NULL);
+        CU_ASSERT(mesmoTabuleiro(antigo, gerado));
+        freeJogo(antigo);
+        freeJogo(gerado);
+    }
+    definirOrcamentoSondagem(orcamento);
+}
+
+void teste_ajuda_automatica_rondas_e_desfazer() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    // Sem casas decididas, a tabela de regras dá o primeiro passo e as regras base fazem o resto
+    int rondas = 0;
+    long disparos[NUM_REGRAS] = {0};
+    CU_ASSERT_EQUAL(ajudaAutomatica(jogo, &rondas, disparos), 25);
+    CU_ASSERT(rondas > 1);
+    CU_ASSERT(disparos[REGRA_SANDUICHE] > 0);
+    CU_ASSERT(verificarVitoria(jogo));
+    freeJogo(jogo);
+    
+    // Pelo comando A as jogadas ficam num só grupo, desfeito por um único 'd'
+    jogo = carregarJogo(TABULEIRO_TEST);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "A"), 0);
+    CU_ASSERT_EQUAL(jogo->tabuleiro[0][4], 'C');
+    CU_ASSERT_EQUAL(jogo->mascaras->indecisas, 0);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "d"), 0);
+    CU_ASSERT_EQUAL(jogo->mascaras->indecisas, 25);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "ecadc");
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+// ===== Testes para a tabela de regras de dedução =====
+
+static void decidirCasaTeste(Jogo *jogo, int linha, int coluna, char novo, IdRegra regra, void *contexto) {
+    (void)regra;
+    (void)contexto;
+    alterarCelula(jogo, linha, coluna, novo);
+}
+
+void teste_regras_sanduiche_e_par() {
+    long disparos[NUM_REGRAS] = {0};
+    
+    // a?a pinta o b do meio; o par aa risca o último a
+    Jogo *jogo = criarJogo(1, 4, "aaba");
+    while (aplicarRegrasDeducao(jogo, 0, decidirCasaTeste, NULL, disparos) > 0);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "aaB#");
+    CU_ASSERT_EQUAL(disparos[REGRA_SANDUICHE], 1);
+    CU_ASSERT_EQUAL(disparos[REGRA_PAR_ADJACENTE], 1);
+    freeJogo(jogo);
+    
+    // O mesmo na vertical
+    jogo = criarJogo(3, 1, "cdc");
+    CU_ASSERT_EQUAL(aplicarRegrasDeducao(jogo, 0, decidirCasaTeste, NULL, NULL), 1);
+    CU_ASSERT_EQUAL(jogo->tabuleiro[1][0], 'D');
+    freeJogo(jogo);
+}
+
+void teste_regras_canto_e_letra_unica() {
+    long disparos[NUM_REGRAS] = {0};
+    
+    // Dois pares num canto: riscam-se o canto e a diagonal
+    Jogo *jogo = criarJogo(2, 3, "aabbbc");
+    CU_ASSERT_EQUAL(aplicarRegrasDeducao(jogo, 0, decidirCasaTeste, NULL, disparos), 2);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "#ab");
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[1], "b#c");
+    CU_ASSERT_EQUAL(disparos[REGRA_CANTO], 2);
+    freeJogo(jogo);
+    
+    // A letra única só é usada quando se procura uma solução, não ao contá-las
+    jogo = criarJogo(1, 2, "ab");
+    CU_ASSERT_EQUAL(aplicarRegrasDeducao(jogo, 0, decidirCasaTeste, NULL, NULL), 0);
+    CU_ASSERT_EQUAL(aplicarRegrasDeducao(jogo, 1, decidirCasaTeste, NULL, disparos), 2);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "AB");
+    CU_ASSERT_EQUAL(disparos[REGRA_LETRA_UNICA], 2);
+    freeJogo(jogo);
+}
+
+// ===== Testes para a sondagem =====
+
+static void fixarCasaTeste(Jogo *jogo, int linha, int coluna, char novo, void *contexto) {
+    (*(int *)contexto)++;
+    alterarCelula(jogo, linha, coluna, novo);
+}
+
+void teste_sondagem_ajuda_automatica() {
+    int orcamento = obterOrcamentoSondagem();
+    
+    // As regras param com casas por decidir; a sondagem acaba o tabuleiro
+    definirOrcamentoSondagem(0);
+    Jogo *jogo = criarJogo(4, 3, "aaddcabceeaa");
+    ajudaAutomatica(jogo, NULL, NULL);
+    CU_ASSERT(jogo->mascaras->indecisas > 0);
+    freeJogo(jogo);
+    
+    definirOrcamentoSondagem(orcamento);
+    jogo = criarJogo(4, 3, "aaddcabceeaa");
+    ajudaAutomatica(jogo, NULL, NULL);
+    CU_ASSERT(verificarVitoria(jogo));
+    CU_ASSERT_EQUAL(contarSolucoes(jogo, 2, NULL, NULL), 1);
+    freeJogo(jogo);
+    jogo = NULL;
+    
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "P -1"), -1);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "P 5"), 0);
+    CU_ASSERT_EQUAL(obterOrcamentoSondagem(), 5);
+    definirOrcamentoSondagem(orcamento);
+}
+
+void teste_sondagem_orcamento() {
+    Jogo *jogo = criarJogo(4, 3, "aaddcabceeaa");
+    propagarDeducoes(jogo, NULL);
+    int indecisas = jogo->mascaras->indecisas;
+    
+    // Sem orçamento nada é experimentado; com uma unidade experimenta-se um único valor
+    int orcamento = 0, fixadas = 0;
+    CU_ASSERT_EQUAL(sondarCasas(jogo, &orcamento, fixarCasaTeste, &fixadas, NULL), 0);
+    EstatisticasResolver estatisticas = {0};
+    orcamento = 1;
+    sondarCasas(jogo, &orcamento, fixarCasaTeste, &fixadas, &estatisticas);
+    CU_ASSERT_EQUAL(orcamento, 0);
+    CU_ASSERT_EQUAL(estatisticas.sondagens, 1);
+    CU_ASSERT_EQUAL(jogo->mascaras->indecisas, indecisas - fixadas);
+    freeJogo(jogo);
+    
+    // Na raiz do resolvedor a sondagem conta nas estatísticas e a solução é a mesma
+    jogo = criarJogo(4, 3, "aaddcabceeaa");
+    estatisticas = (EstatisticasResolver){0};
+    CU_ASSERT_EQUAL(resolverComPropagacao(jogo, &estatisticas), 1);
+    CU_ASSERT(estatisticas.sondagens > 0);
+    CU_ASSERT(verificarVitoria(jogo));
+    freeJogo(jogo);
+}
+
 // ===== Testes para o comando de resolver jogo (R) =====
 void teste_resolver_jogo() {
     criar_arquivo_resolver();
@@ -591,6 +1106,842 @@ void teste_resolver_jogo() {
     freeJogo(jogo);
 }
 
+// ===== Testes para o resolvedor com propagação =====
+void teste_resolver_com_propagacao() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    EstatisticasResolver estatisticas = {0};
+    int resultado = resolverComPropagacao(jogo, &estatisticas);
+    
+    // O tabuleiro de teste tem solução, que tem de ser válida
+    CU_ASSERT_EQUAL(resultado, 1);
+    CU_ASSERT_EQUAL(verificarVitoria(jogo), 1);
+    CU_ASSERT(estatisticas.nos > 0);
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+void teste_propagar_deducoes_contradicao() {
+    FILE *file = fopen(TABULEIRO_CONTRADICAO_TEST, "w");
+    if (file) {
+        // Duas brancas iguais na mesma linha
+        fprintf(file, "2 2\nAA\nbc\n");
+        fclose(file);
+    }
+    Jogo *jogo = carregarJogo(TABULEIRO_CONTRADICAO_TEST);
+    
+    CU_ASSERT_PTR_NOT_NULL(jogo);
+    CU_ASSERT_EQUAL(propagarDeducoes(jogo, NULL), 0);
+    
+    freeJogo(jogo);
+    remove(TABULEIRO_CONTRADICAO_TEST);
+}
+
+void teste_resolver_sem_solucao_preserva_tabuleiro() {
+    FILE *file = fopen(TABULEIRO_CONTRADICAO_TEST, "w");
+    if (file) {
+        // Qualquer escolha deixa as brancas separadas ou duas letras iguais
+        fprintf(file, "2 2\naa\naa\n");
+        fclose(file);
+    }
+    Jogo *jogo = carregarJogo(TABULEIRO_CONTRADICAO_TEST);
+    
+    CU_ASSERT_PTR_NOT_NULL(jogo);
+    CU_ASSERT_EQUAL(resolverComPropagacao(jogo, NULL), 0);
+    
+    // O rasto desfaz todas as tentativas
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "aa");
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[1], "aa");
+    CU_ASSERT(regiaoNaoRiscadaConexa(jogo));
+    
+    freeJogo(jogo);
+    remove(TABULEIRO_CONTRADICAO_TEST);
+}
+
+void teste_rasto_volta_ao_nivel() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    Rasto *rasto = criarRasto(jogo);
+    
+    CU_ASSERT_PTR_NOT_NULL(rasto);
+    
+    // A propagação a partir de uma casa branca fica toda no nível aberto
+    abrirNivel(rasto);
+    abrirNivel(rasto);
+    CU_ASSERT_EQUAL(procurarSolucao(jogo, rasto, NULL), 1);
+    CU_ASSERT(rasto->topo > 0);
+    
+    voltarAoNivel(jogo, rasto, 0);
+    CU_ASSERT_EQUAL(rasto->topo, 0);
+    CU_ASSERT_EQUAL(rasto->nivel, 0);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "ecadc");
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[4], "accbb");
+    
+    freeRasto(rasto);
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+void teste_resolver_jogo_regista_movimentos() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    CU_ASSERT_EQUAL(resolverJogo(jogo), 0);
+    CU_ASSERT_PTR_NOT_NULL(ultimoMovimento(jogo));
+    
+    // Desfazer toda a resolução repõe o tabuleiro inicial
+    while (numeroMovimentos(jogo) > 0) desfazerMovimento(jogo);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "ecadc");
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[4], "accbb");
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+void teste_repor_tabuleiro_inicial() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    uint64_t hashInicial = jogo->mascaras->hash;
+    
+    pintarBranco(jogo, "a1");
+    riscar(jogo, "b1");
+    iniciarAgrupamentoMovimentos(jogo);
+    pintarBranco(jogo, "c2");
+    pintarBranco(jogo, "d2");
+    finalizarAgrupamentoMovimentos(jogo);
+    pintarBranco(jogo, "a1");   // Casa alterada duas vezes: reposta uma só vez
+    
+    // Uma passagem repõe as 4 casas alteradas e regista-as como um grupo
+    CU_ASSERT_EQUAL(reporTabuleiroInicial(jogo), 4);
+    CU_ASSERT_EQUAL(numeroMovimentos(jogo), 9);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "ecadc");
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[1], "dcdec");
+    CU_ASSERT_EQUAL(jogo->mascaras->hash, hashInicial);
+    CU_ASSERT_EQUAL(reporTabuleiroInicial(jogo), 0);
+    
+    // Um único 'd' desfaz a reposição
+    CU_ASSERT_EQUAL(desfazerMovimento(jogo), 0);
+    CU_ASSERT_EQUAL(numeroMovimentos(jogo), 5);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "E#adc");
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[1], "dcDEc");
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+void teste_tabuleiro_inicial_de_jogo_gravado() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    pintarBranco(jogo, "a1");
+    riscar(jogo, "b1");
+    CU_ASSERT_EQUAL(gravarJogo(jogo, "jogo_salvo.txt"), 0);
+    freeJogo(jogo);
+    
+    // O tabuleiro inicial de um jogo gravado é o anterior aos movimentos do histórico
+    jogo = carregarJogo("jogo_salvo.txt");
+    CU_ASSERT_PTR_NOT_NULL(jogo);
+    if (jogo) {
+        CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "E#adc");
+        CU_ASSERT_EQUAL(resolverJogo(jogo), 0);
+        CU_ASSERT_EQUAL(verificarVitoria(jogo), 1);
+        
+        // Os movimentos da reposição levam ao tabuleiro inicial, não à solução registada a seguir
+        CU_ASSERT_EQUAL(irParaMovimento(jogo, 4), 0);
+        CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "ecadc");
+        
+        // Desfazer a solução e a reposição volta ao tabuleiro carregado
+        while (numeroMovimentos(jogo) > 2) desfazerMovimento(jogo);
+        CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "E#adc");
+        freeJogo(jogo);
+    }
+    remove("jogo_salvo.txt");
+    limpar_arquivo_teste();
+}
+
+void teste_resolver_paralelo_igual_sequencial() {
+    criar_arquivo_teste();
+    Jogo *sequencial = carregarJogo(TABULEIRO_TEST);
+    Jogo *paralelo = carregarJogo(TABULEIRO_TEST);
+    
+    CU_ASSERT_EQUAL(resolverComPropagacao(sequencial, NULL), 1);
+    CU_ASSERT_EQUAL(resolverParalelo(paralelo, 4, NULL), 1);
+    
+    // A solução é única, por isso as duas procuras chegam ao mesmo tabuleiro
+    for (int i = 0; i < sequencial->linhas; i++) {
+        CU_ASSERT_STRING_EQUAL(paralelo->tabuleiro[i], sequencial->tabuleiro[i]);
+    }
+    CU_ASSERT(verificarVitoria(paralelo));
+    
+    freeJogo(sequencial);
+    freeJogo(paralelo);
+    limpar_arquivo_teste();
+}
+
+void teste_resolver_paralelo_sem_solucao() {
+    FILE *file = fopen(TABULEIRO_CONTRADICAO_TEST, "w");
+    if (file) {
+        fprintf(file, "2 2\naa\naa\n");
+        fclose(file);
+    }
+    Jogo *jogo = carregarJogo(TABULEIRO_CONTRADICAO_TEST);
+    
+    CU_ASSERT_EQUAL(resolverParalelo(jogo, 3, NULL), 0);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "aa");
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[1], "aa");
+    
+    freeJogo(jogo);
+    remove(TABULEIRO_CONTRADICAO_TEST);
+}
+
+void teste_processar_comando_resolver_threads() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "R 0"), -1);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "R 2"), 0);
+    CU_ASSERT(verificarVitoria(jogo));
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+void teste_heuristicas_ramificacao() {
+    criar_arquivo_teste();
+    Heuristica anterior = obterHeuristica();
+    
+    // Todas as heurísticas chegam à mesma solução e contam o mesmo número de soluções
+    for (int h = 0; h < NUM_HEURISTICAS; h++) {
+        definirHeuristica(h);
+        Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+        CU_ASSERT_EQUAL(resolverComPropagacao(jogo, NULL), 1);
+        CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "E#ADC");
+        freeJogo(jogo);
+        
+        Jogo *ambiguo = criarJogo(2, 2, "abba");
+        CU_ASSERT_EQUAL(contarSolucoes(ambiguo, 10, NULL, NULL), 5);
+        freeJogo(ambiguo);
+    }
+    
+    CU_ASSERT_EQUAL(procurarHeuristica("primeira"), HEURISTICA_PRIMEIRA);
+    CU_ASSERT_EQUAL(procurarHeuristica("conflitos"), HEURISTICA_CONFLITOS);
+    CU_ASSERT_EQUAL(procurarHeuristica("outra"), -1);
+    
+    definirHeuristica(anterior);
+    limpar_arquivo_teste();
+}
+
+void teste_processar_comando_heuristica() {
+    Jogo *jogo = NULL;
+    Heuristica anterior = obterHeuristica();
+    
+    // Não precisa de um jogo carregado
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "H"), 0);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "H primeira"), 0);
+    CU_ASSERT_EQUAL(obterHeuristica(), HEURISTICA_PRIMEIRA);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "H nenhuma"), -1);
+    CU_ASSERT_EQUAL(obterHeuristica(), HEURISTICA_PRIMEIRA);
+    
+    definirHeuristica(anterior);
+}
+
+void teste_aprendizagem_nogoods() {
+    Heuristica anterior = obterHeuristica();
+    int orcamento = obterOrcamentoSondagem();
+    definirHeuristica(HEURISTICA_PRIMEIRA);
+    definirOrcamentoSondagem(0);
+    
+    // Sem solução: os nogoods aprendidos voltam a ser usados e o tabuleiro fica intacto
+    Jogo *jogo = criarJogo(6, 6, "ouvgrowdiqtkvaqqvdcjcfmfstjjwtcdvguv");
+    EstatisticasResolver estatisticas = {0};
+    CU_ASSERT_EQUAL(resolverComPropagacao(jogo, &estatisticas), 0);
+    CU_ASSERT(estatisticas.nogoods > 0);
+    CU_ASSERT(estatisticas.nogoods <= estatisticas.retrocessos);
+    CU_ASSERT(estatisticas.usosNogoods > 0);
+    CU_ASSERT(estatisticas.memoriaNogoods > 0 && estatisticas.memoriaNogoods <= MEMORIA_NOGOODS);
+    CU_ASSERT_EQUAL(jogo->mascaras->indecisas, 36);
+    CU_ASSERT_EQUAL(contarSolucoes(jogo, 1, NULL, NULL), 0);
+    freeJogo(jogo);
+    
+    // Um conflito que não depende da última decisão salta esse nível
+    jogo = criarJogo(8, 8, "mbtinzitmymjsjetdeiktsdekaoxmtxkrzjauojfseukbjkjdgjputagrsrcyruc");
+    estatisticas = (EstatisticasResolver){0};
+    CU_ASSERT_EQUAL(resolverComPropagacao(jogo, &estatisticas), 0);
+    CU_ASSERT(estatisticas.saltos > 0);
+    CU_ASSERT_EQUAL(contarSolucoes(jogo, 1, NULL, NULL), 0);
+    freeJogo(jogo);
+    
+    // Com aprendizagem a solução continua a ser a mesma
+    criar_arquivo_teste();
+    jogo = carregarJogo(TABULEIRO_TEST);
+    CU_ASSERT_EQUAL(resolverComPropagacao(jogo, NULL), 1);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "E#ADC");
+    
+    Aprendizagem *aprendizagem = criarAprendizagem(jogo);
+    CU_ASSERT_PTR_NOT_NULL(aprendizagem);
+    CU_ASSERT_EQUAL(aprendizagem->palavras, 1);
+    CU_ASSERT_EQUAL(aprendizagem->numNogoods, 0);
+    CU_ASSERT_EQUAL(aprendizagem->maxLiterais * (int)sizeof(int), MEMORIA_NOGOODS);
+    freeAprendizagem(aprendizagem);
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+    
+    definirHeuristica(anterior);
+    definirOrcamentoSondagem(orcamento);
+}
+
+void teste_tabela_transposicao() {
+    // 64 bytes: dois grupos de 4 entradas
+    TabelaTransposicao *tabela = criarTabelaTransposicao(64);
+    CU_ASSERT_PTR_NOT_NULL(tabela);
+    CU_ASSERT_EQUAL(tabela->mascara, 7);
+    CU_ASSERT_PTR_NULL(criarTabelaTransposicao(16));
+    
+    CU_ASSERT_FALSE(consultarTransposicao(tabela, 0x10));
+    guardarTransposicao(tabela, 0x10);
+    CU_ASSERT(consultarTransposicao(tabela, 0x10));
+    
+    // Com o grupo cheio, uma nova entrada substitui uma das antigas
+    for (uint64_t k = 1; k <= 4; k++) guardarTransposicao(tabela, 0x10 + 8 * k);
+    CU_ASSERT(consultarTransposicao(tabela, 0x30));
+    int guardadas = 0;
+    for (uint64_t k = 0; k <= 4; k++) guardadas += consultarTransposicao(tabela, 0x10 + 8 * k);
+    CU_ASSERT_EQUAL(guardadas, 4);
+    freeTabelaTransposicao(tabela);
+    
+    // A procura consulta a tabela em cada nó; sem tabela a resposta é a mesma
+    Heuristica anterior = obterHeuristica();
+    int orcamento = obterOrcamentoSondagem();
+    size_t memoria = obterMemoriaTransposicao();
+    definirHeuristica(HEURISTICA_PRIMEIRA);
+    definirOrcamentoSondagem(0);
+    for (int usar = 0; usar < 2; usar++) {
+        definirMemoriaTransposicao(usar ? memoria : 0);
+        Jogo *jogo = criarJogo(6, 6, "ouvgrowdiqtkvaqqvdcjcfmfstjjwtcdvguv");
+        EstatisticasResolver estatisticas = {0};
+        CU_ASSERT_EQUAL(resolverComPropagacao(jogo, &estatisticas), 0);
+        if (usar) CU_ASSERT(estatisticas.falhasTransposicao > 0);
+        else CU_ASSERT_EQUAL(estatisticas.falhasTransposicao, 0);
+        freeJogo(jogo);
+    }
+    
+    Jogo *jogo = NULL;
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "T -1"), -1);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "T 64"), 0);
+    CU_ASSERT_EQUAL(obterMemoriaTransposicao(), 64 * 1024);
+    
+    definirMemoriaTransposicao(memoria);
+    definirHeuristica(anterior);
+    definirOrcamentoSondagem(orcamento);
+}
+
+// ===== Testes para a validação estruturada =====
+
+void teste_validar_tabuleiro_estruturado() {
+    Jogo *jogo = criarJogo(2, 3, "abadef");
+    Violacao lista[16];
+    ResultadoValidacao resultado = { .lista = lista, .capacidade = 16 };
+    
+    // Só a linha 1 tem duplicados
+    CU_ASSERT_EQUAL(validarTabuleiro(jogo, &resultado), 1);
+    CU_ASSERT_EQUAL(resultado.porTipo[VIOLACAO_DUPLICADOS_LINHA], 1);
+    CU_ASSERT_EQUAL(resultado.numListadas, 1);
+    CU_ASSERT_EQUAL(lista[0].tipo, VIOLACAO_DUPLICADOS_LINHA);
+    CU_ASSERT_EQUAL(lista[0].linha, 0);
+    
+    // a1 e b1 riscadas: par adjacente e vizinhos por decidir
+    alterarCelula(jogo, 0, 0, '#');
+    alterarCelula(jogo, 0, 1, '#');
+    CU_ASSERT_EQUAL(validarTabuleiro(jogo, &resultado), 4);
+    CU_ASSERT_EQUAL(resultado.porTipo[VIOLACAO_DUPLICADOS_LINHA], 0);
+    CU_ASSERT_EQUAL(resultado.porTipo[VIOLACAO_RISCADAS_ADJACENTES], 1);
+    CU_ASSERT_EQUAL(resultado.porTipo[VIOLACAO_VIZINHO_NAO_BRANCO], 3);
+    CU_ASSERT_EQUAL(lista[0].tipo, VIOLACAO_VIZINHO_NAO_BRANCO);
+    CU_ASSERT_EQUAL(lista[0].linha, 1);
+    CU_ASSERT_EQUAL(lista[0].coluna, 0);
+    
+    freeJogo(jogo);
+}
+
+void teste_validar_tabuleiro_so_contagens() {
+    Jogo *jogo = criarJogo(3, 1, "abc");
+    ResultadoValidacao resultado = { .lista = NULL };
+    
+    // Brancas separadas por uma riscada
+    alterarCelula(jogo, 0, 0, 'A');
+    alterarCelula(jogo, 1, 0, '#');
+    alterarCelula(jogo, 2, 0, 'C');
+    CU_ASSERT_EQUAL(validarTabuleiro(jogo, &resultado), 1);
+    CU_ASSERT_EQUAL(resultado.porTipo[VIOLACAO_BRANCAS_DESCONEXAS], 1);
+    CU_ASSERT_EQUAL(resultado.numListadas, 0);
+    CU_ASSERT_EQUAL(verificarVitoria(jogo), 0);
+    
+    CU_ASSERT_EQUAL(validarTabuleiro(NULL, &resultado), -1);
+    freeJogo(jogo);
+}
+
+// ===== Testes para os contadores do tabuleiro =====
+
+void teste_contadores_incrementais() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    MascarasTabuleiro *m = jogo->mascaras;
+    
+    CU_ASSERT_EQUAL(m->indecisas, 25);
+    CU_ASSERT_EQUAL(m->paresRiscados, 0);
+    int excessoInicial = m->excessoLetras;
+    CU_ASSERT(excessoInicial > 0);
+    
+    // Riscar a1 e a2 cria um par de riscadas adjacentes
+    riscar(jogo, "a1");
+    riscar(jogo, "a2");
+    CU_ASSERT_EQUAL(m->indecisas, 23);
+    CU_ASSERT_EQUAL(m->paresRiscados, 1);
+    
+    // Desfazer repõe todos os contadores
+    desfazerMovimento(jogo);
+    desfazerMovimento(jogo);
+    CU_ASSERT_EQUAL(m->indecisas, 25);
+    CU_ASSERT_EQUAL(m->paresRiscados, 0);
+    CU_ASSERT_EQUAL(m->excessoLetras, excessoInicial);
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+void teste_hash_zobrist() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    Jogo *outro = carregarJogo(TABULEIRO_TEST);
+    uint64_t inicial = jogo->mascaras->hash;
+    CU_ASSERT(inicial != 0);
+    
+    // A mesma posição por ordens diferentes tem o mesmo hash
+    riscar(jogo, "a1");
+    pintarBranco(jogo, "b1");
+    CU_ASSERT(jogo->mascaras->hash != inicial);
+    pintarBranco(outro, "b1");
+    riscar(outro, "a1");
+    CU_ASSERT_EQUAL(jogo->mascaras->hash, outro->mascaras->hash);
+    
+    // O hash incremental é igual ao calculado de raiz
+    MascarasTabuleiro *refeitas = criarMascaras(jogo);
+    CU_ASSERT_EQUAL(refeitas->hash, jogo->mascaras->hash);
+    freeMascaras(refeitas);
+    
+    desfazerMovimento(jogo);
+    desfazerMovimento(jogo);
+    CU_ASSERT_EQUAL(jogo->mascaras->hash, inicial);
+    
+    freeJogo(jogo);
+    freeJogo(outro);
+    limpar_arquivo_teste();
+}
+
+void teste_arena_marcas() {
+    Arena *arena = criarArena(256);
+    CU_ASSERT_PTR_NOT_NULL(arena);
+    if (!arena) return;
+    
+    char *a = reservarArena(arena, 10);
+    MarcaArena marca = marcarArena(arena);
+    int *b = reservarArenaZerada(arena, 100 * sizeof(int));
+    char *grande = reservarArena(arena, 1000);     // Maior que um bloco: bloco próprio
+    CU_ASSERT(a && b && grande);
+    CU_ASSERT_EQUAL((uintptr_t)b % _Alignof(max_align_t), 0);
+    CU_ASSERT_EQUAL(b[99], 0);
+    CU_ASSERT_EQUAL(arena->estatisticas.reservas, 3);
+    CU_ASSERT_EQUAL(arena->estatisticas.blocos, 3);
+    size_t pico = arena->estatisticas.pico;
+    
+    // Voltar à marca devolve as duas últimas reservas; repetir o padrão não pede blocos novos
+    voltarArena(arena, marca);
+    CU_ASSERT_EQUAL(arena->estatisticas.emUso, marca.emUso);
+    CU_ASSERT(reservarArena(arena, 100 * sizeof(int)) && reservarArena(arena, 1000));
+    CU_ASSERT_EQUAL(arena->estatisticas.blocos, 3);
+    CU_ASSERT_EQUAL(arena->estatisticas.reutilizacoes, 2);
+    CU_ASSERT_EQUAL(arena->estatisticas.pico, pico);
+    
+    // Uma marca já ultrapassada não tem efeito
+    voltarArena(arena, (MarcaArena){0});
+    CU_ASSERT_EQUAL(arena->estatisticas.emUso, 0);
+    voltarArena(arena, marca);
+    CU_ASSERT_EQUAL(arena->estatisticas.emUso, 0);
+    
+    freeArena(arena);
+}
+
+void teste_slab_reaproveita() {
+    Slab slab;
+    iniciarSlab(&slab, 40, 0);
+    
+    char *a = reservarSlab(&slab);
+    char *b = reservarSlab(&slab);
+    CU_ASSERT(a && b && a != b);
+    devolverSlab(&slab, a);
+    CU_ASSERT(reservarSlab(&slab) == a);
+    CU_ASSERT_EQUAL(slab.arena.estatisticas.devolvidos, 1);
+    CU_ASSERT_EQUAL(slab.arena.estatisticas.reservas, 2);
+    
+    // Os objetos não devolvidos são libertados com o slab
+    libertarSlab(&slab);
+    CU_ASSERT_EQUAL(slab.arena.estatisticas.total, 0);
+}
+
+void teste_arena_jogo_reaproveitada() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    CU_ASSERT_PTR_NULL(jogo->arena);
+    
+    CU_ASSERT_EQUAL(contarSolucoes(jogo, 2, NULL, NULL), 1);
+    CU_ASSERT_PTR_NOT_NULL(jogo->arena);
+    if (!jogo->arena) return;
+    long blocos = jogo->arena->estatisticas.blocos;
+    CU_ASSERT(blocos > 0);
+    CU_ASSERT_EQUAL(jogo->arena->estatisticas.emUso, 0);
+    
+    // As procuras e a ajuda seguintes reaproveitam os blocos da primeira
+    CU_ASSERT_EQUAL(contarSolucoes(jogo, 2, NULL, NULL), 1);
+    CU_ASSERT(ajudaAutomatica(jogo, NULL, NULL) > 0);
+    CU_ASSERT_EQUAL(resolverComPropagacao(jogo, NULL), 1);
+    CU_ASSERT_EQUAL(jogo->arena->estatisticas.blocos, blocos);
+    CU_ASSERT(jogo->arena->estatisticas.reutilizacoes > 0);
+    CU_ASSERT_EQUAL(jogo->arena->estatisticas.emUso, 0);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "M"), 0);
+    
+    // A cópia tem a sua própria arena
+    Jogo *copia = copiarJogo(jogo);
+    CU_ASSERT_PTR_NULL(copia->arena);
+    freeJogo(copia);
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+void teste_vitoria_pelos_contadores() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    CU_ASSERT_EQUAL(verificarVitoria(jogo), 0);
+    CU_ASSERT_EQUAL(resolverComPropagacao(jogo, NULL), 1);
+    CU_ASSERT_EQUAL(jogo->mascaras->indecisas, 0);
+    CU_ASSERT_EQUAL(jogo->mascaras->excessoLetras, 0);
+    CU_ASSERT_EQUAL(verificarVitoria(jogo), 1);
+    
+    // Uma branca repetida basta para deixar de ser vitória
+    for (int j = 0; j < jogo->colunas; j++) {
+        if (jogo->tabuleiro[0][j] == '#') {
+            // A vizinha de uma riscada é branca: copiar a sua letra
+            alterarCelula(jogo, 0, j, jogo->tabuleiro[0][j == 0 ? 1 : j - 1]);
+            break;
+        }
+    }
+    CU_ASSERT(jogo->mascaras->excessoLetras > 0);
+    CU_ASSERT_EQUAL(verificarVitoria(jogo), 0);
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+// ===== Testes para a validação incremental =====
+
+static int mesmoResultado(ResultadoValidacao *a, ResultadoValidacao *b) {
+    if (a->total != b->total || a->numListadas != b->numListadas) return 0;
+    for (int t = 0; t < NUM_TIPOS_VIOLACAO; t++) {
+        if (a->porTipo[t] != b->porTipo[t]) return 0;
+    }
+    for (int k = 0; k < a->numListadas; k++) {
+        if (a->lista[k].tipo != b->lista[k].tipo || a->lista[k].linha != b->lista[k].linha ||
+            a->lista[k].coluna != b->lista[k].coluna) return 0;
+    }
+    return 1;
+}
+
+void teste_validacao_incremental_igual_completa() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    int capacidade = MAX_VIOLACOES(jogo);
+    ResultadoValidacao cache = { .lista = malloc(capacidade * sizeof(Violacao)), .capacidade = capacidade };
+    ResultadoValidacao completa = { .lista = malloc(capacidade * sizeof(Violacao)), .capacidade = capacidade };
+    ResultadoValidacao contagens = { .lista = NULL };
+    
+    // Sequência fixa de jogadas, desfeitas no fim, comparando as duas validações a cada passo
+    const char *jogadas[] = {"r a1", "r b1", "b a2", "r b2", "r c3", "b c2", "r e5", "r d5", "b a1"};
+    int iguais = 1;
+    for (int k = 0; k < 9; k++) {
+        char coordenada[3] = {jogadas[k][2], jogadas[k][3], '\0'};
+        if (jogadas[k][0] == 'r') riscar(jogo, coordenada); else pintarBranco(jogo, coordenada);
+        
+        validarTabuleiro(jogo, &cache);
+        validarTabuleiroCompleto(jogo, &completa);
+        validarTabuleiro(jogo, &contagens);
+        iguais &= mesmoResultado(&cache, &completa);
+        iguais &= contagens.total == completa.total;
+    }
+    while (numeroMovimentos(jogo) > 0) {
+        desfazerMovimento(jogo);
+        validarTabuleiro(jogo, &cache);
+        validarTabuleiroCompleto(jogo, &completa);
+        iguais &= mesmoResultado(&cache, &completa);
+    }
+    CU_ASSERT(iguais);
+    CU_ASSERT_EQUAL(jogo->mascaras->paresRiscadaIndecisa, 0);
+    
+    free(cache.lista);
+    free(completa.lista);
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+void teste_validacao_incremental_vizinhanca() {
+    Jogo *jogo = criarJogo(3, 3, "abcdefghi");
+    MascarasTabuleiro *m = jogo->mascaras;
+    
+    // Riscar o centro deixa quatro vizinhas por decidir
+    alterarCelula(jogo, 1, 1, '#');
+    CU_ASSERT_EQUAL(m->paresRiscadaIndecisa, 4);
+    CU_ASSERT(m->violacoesLinha[1] & 2);
+    
+    // Pintar as vizinhas retira a riscada do conjunto de violações
+    alterarCelula(jogo, 0, 1, 'B');
+    alterarCelula(jogo, 1, 0, 'D');
+    alterarCelula(jogo, 1, 2, 'F');
+    CU_ASSERT(m->violacoesLinha[1] & 2);
+    alterarCelula(jogo, 2, 1, 'H');
+    CU_ASSERT_EQUAL(m->paresRiscadaIndecisa, 0);
+    CU_ASSERT_EQUAL(m->violacoesLinha[1], 0);
+    
+    freeJogo(jogo);
+}
+
+// ===== Testes para contagem de soluções e geração =====
+
+void teste_contar_solucoes() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    CU_ASSERT_EQUAL(contarSolucoes(jogo, 2, NULL, NULL), 1);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "ecadc");
+    freeJogo(jogo);
+    
+    // Sem letras repetidas, tudo branco é solução, mas riscar um canto também
+    Jogo *ambiguo = criarJogo(2, 2, "abba");
+    CU_ASSERT_PTR_NOT_NULL(ambiguo);
+    CU_ASSERT_STRING_EQUAL(ambiguo->tabuleiro[1], "ba");
+    CU_ASSERT_EQUAL(contarSolucoes(ambiguo, 3, NULL, NULL), 3);
+    CU_ASSERT_EQUAL(contarSolucoes(ambiguo, 10, NULL, NULL), 5);
+    freeJogo(ambiguo);
+    
+    limpar_arquivo_teste();
+}
+
+void teste_contar_solucoes_com_nogoods() {
+    Heuristica anterior = obterHeuristica();
+    definirHeuristica(HEURISTICA_PRIMEIRA);
+    
+    // Os ramos sem soluções aprendem nogoods sem perder nenhuma das 38 soluções
+    Jogo *jogo = criarJogo(4, 4, "acdedeacadebedbd");
+    EstatisticasResolver estatisticas = {0};
+    CU_ASSERT_EQUAL(contarSolucoes(jogo, 100, NULL, &estatisticas), 38);
+    CU_ASSERT(estatisticas.nogoods > 0);
+    CU_ASSERT(estatisticas.falhasTransposicao > 0);
+    CU_ASSERT_EQUAL(contarSolucoes(jogo, 2, NULL, NULL), 2);
+    CU_ASSERT_EQUAL(jogo->mascaras->indecisas, 16);
+    
+    // A contagem pelo jogo não altera o tabuleiro nem o histórico
+    CU_ASSERT_EQUAL(contarSolucoesJogo(jogo, 2), 2);
+    CU_ASSERT_EQUAL(contarSolucoesJogo(jogo, 40), 38);
+    CU_ASSERT_EQUAL(contarSolucoesJogo(jogo, 0), -1);
+    CU_ASSERT_EQUAL(numeroMovimentos(jogo), 0);
+    CU_ASSERT_STRING_EQUAL(jogo->tabuleiro[0], "acde");
+    freeJogo(jogo);
+    
+    definirHeuristica(anterior);
+}
+
+void teste_processar_comando_contar() {
+    Jogo *jogo = NULL;
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "C"), -1);
+    
+    criar_arquivo_teste();
+    jogo = carregarJogo(TABULEIRO_TEST);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "C"), 0);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "C 5"), 0);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "C 0"), -1);
+    CU_ASSERT_EQUAL(processarComandos(&jogo, "C x"), -1);
+    CU_ASSERT_EQUAL(jogo->mascaras->indecisas, 25);
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
+void teste_gerar_jogo_unico() {
+    ParametrosGerador parametros = {6, 6, 40, 1};
+    uint64_t estado = 12345;
+    
+    for (int k = 0; k < 5; k++) {
+        Jogo *jogo = gerarJogoUnico(&parametros, &estado);
+        CU_ASSERT_PTR_NOT_NULL(jogo);
+        if (!jogo) continue;
+        
+        CU_ASSERT_EQUAL(jogo->linhas, 6);
+        CU_ASSERT_EQUAL(jogo->colunas, 6);
+        for (int i = 0; i < jogo->linhas; i++) {
+            for (int j = 0; j < jogo->colunas; j++) {
+                CU_ASSERT(jogo->tabuleiro[i][j] >= 'a' && jogo->tabuleiro[i][j] <= 'z');
+            }
+        }
+        CU_ASSERT_EQUAL(contarSolucoes(jogo, 2, NULL, NULL), 1);
+
+        // O tabuleiro inicial é o gerado: repô-lo não muda nenhuma casa
+        CU_ASSERT_EQUAL(memcmp(jogo->inicial, jogo->celulas, (jogo->linhas + 2) * jogo->largura), 0);
+        CU_ASSERT_EQUAL(reporTabuleiroInicial(jogo), 0);
+        CU_ASSERT_EQUAL(contarSolucoes(jogo, 2, NULL, NULL), 1);
+        freeJogo(jogo);
+    }
+    
+    // 1x1: a única casa nunca é riscada no padrão, e como riscá-la também é solução, o gerador
+    // desiste em vez de procurar para sempre uma branca de onde copiar a letra
+    parametros.linhas = parametros.colunas = 1;
+    parametros.densidade = 100;
+    CU_ASSERT_PTR_NULL(gerarJogoUnico(&parametros, &estado));
+}
+
+// Linhas com mais de NUM_LETRAS casas: o gerador risca as brancas a mais
+void teste_gerar_jogo_grande() {
+    ParametrosGerador parametros = {30, 30, 40, 1};
+    uint64_t estado = 12345;
+    
+    Jogo *jogo = gerarJogoUnico(&parametros, &estado);
+    CU_ASSERT_PTR_NOT_NULL(jogo);
+    if (jogo) {
+        CU_ASSERT_EQUAL(contarSolucoes(jogo, 2, NULL, NULL), 1);
+        freeJogo(jogo);
+    }
+    
+    parametros.colunas = MAX_DIMENSAO_GERADOR + 1;
+    CU_ASSERT_PTR_NULL(gerarJogoUnico(&parametros, &estado));
+}
+
+// ===== Testes para a resolução em lote =====
+
+void teste_resolver_lote_lista() {
+    criar_arquivo_teste();
+    FILE *file = fopen(TABULEIRO_CONTRADICAO_TEST, "w");
+    if (file) {
+        fprintf(file, "2 2\naa\naa\n");
+        fclose(file);
+    }
+    file = fopen(LISTA_LOTE_TEST, "w");
+    if (file) {
+        fprintf(file, "%s\n\n%s\n", TABULEIRO_TEST, TABULEIRO_CONTRADICAO_TEST);
+        fclose(file);
+    }
+    
+    ResultadoLote resultado;
+    CU_ASSERT_EQUAL(resolverLote(LISTA_LOTE_TEST, SAIDA_LOTE_TEST, 2, &resultado), 0);
+    CU_ASSERT_EQUAL(resultado.resolvidos, 1);
+    CU_ASSERT_EQUAL(resultado.semSolucao, 1);
+    CU_ASSERT_EQUAL(resultado.erros, 0);
+    
+    // A solução é gravada no formato do comando 'g' e pode ser carregada de novo
+    Jogo *jogo = carregarJogo(SAIDA_LOTE_TEST "/" TABULEIRO_TEST);
+    CU_ASSERT_PTR_NOT_NULL(jogo);
+    if (jogo) CU_ASSERT(verificarVitoria(jogo));
+    freeJogo(jogo);
+    
+    char linha[32] = {0};
+    file = fopen(SAIDA_LOTE_TEST "/" TABULEIRO_CONTRADICAO_TEST, "r");
+    CU_ASSERT_PTR_NOT_NULL(file);
+    if (file) {
+        CU_ASSERT_PTR_NOT_NULL(fgets(linha, sizeof(linha), file));
+        fclose(file);
+    }
+    CU_ASSERT_STRING_EQUAL(linha, "unsolvable\n");
+    
+    remove(SAIDA_LOTE_TEST "/" TABULEIRO_TEST);
+    remove(SAIDA_LOTE_TEST "/" TABULEIRO_CONTRADICAO_TEST);
+    rmdir(SAIDA_LOTE_TEST);
+    remove(LISTA_LOTE_TEST);
+    remove(TABULEIRO_CONTRADICAO_TEST);
+    limpar_arquivo_teste();
+}
+
+void teste_resolver_lote_ficheiro_invalido() {
+    FILE *file = fopen(LISTA_LOTE_TEST, "w");
+    if (file) {
+        fprintf(file, "%s\n", ARQUIVO_INEXISTENTE);
+        fclose(file);
+    }
+    
+    ResultadoLote resultado;
+    CU_ASSERT_EQUAL(resolverLote(LISTA_LOTE_TEST, SAIDA_LOTE_TEST, 1, &resultado), -1);
+    CU_ASSERT_EQUAL(resultado.erros, 1);
+    
+    int numFicheiros = 0;
+    CU_ASSERT_PTR_NULL(listarTabuleiros(ARQUIVO_INEXISTENTE, &numFicheiros));
+    CU_ASSERT_EQUAL(numFicheiros, -1);
+    
+    rmdir(SAIDA_LOTE_TEST);
+    remove(LISTA_LOTE_TEST);
+}
+
+void teste_resolver_lote_ignora_movimentos() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    riscar(jogo, "a1");     // Errado: a1 é branca na única solução
+    CU_ASSERT_EQUAL(gravarJogo(jogo, "jogo_salvo.txt"), 0);
+    freeJogo(jogo);
+    FILE *file = fopen(LISTA_LOTE_TEST, "w");
+    if (file) {
+        fprintf(file, "jogo_salvo.txt\n");
+        fclose(file);
+    }
+    
+    // O lote resolve o puzzle gravado, não a posição com o movimento errado
+    ResultadoLote resultado;
+    CU_ASSERT_EQUAL(resolverLote(LISTA_LOTE_TEST, SAIDA_LOTE_TEST, 1, &resultado), 0);
+    CU_ASSERT_EQUAL(resultado.resolvidos, 1);
+    CU_ASSERT_EQUAL(resultado.semSolucao, 0);
+    jogo = carregarJogo(SAIDA_LOTE_TEST "/jogo_salvo.txt");
+    CU_ASSERT_PTR_NOT_NULL(jogo);
+    if (jogo) CU_ASSERT(verificarVitoria(jogo));
+    freeJogo(jogo);
+    
+    remove(SAIDA_LOTE_TEST "/jogo_salvo.txt");
+    rmdir(SAIDA_LOTE_TEST);
+    remove(LISTA_LOTE_TEST);
+    remove("jogo_salvo.txt");
+    limpar_arquivo_teste();
+}
+
+void teste_resolver_lote_nomes_repetidos() {
+    criar_arquivo_teste();
+    mkdir(PASTA_LOTE_TEST, 0755);
+    rename(TABULEIRO_TEST, PASTA_LOTE_TEST "/" TABULEIRO_TEST);
+    criar_arquivo_teste();
+    FILE *file = fopen(LISTA_LOTE_TEST, "w");
+    if (file) {
+        fprintf(file, "%s\n%s/%s\n", TABULEIRO_TEST, PASTA_LOTE_TEST, TABULEIRO_TEST);
+        fclose(file);
+    }
+    
+    // As duas soluções iriam para o mesmo ficheiro: o lote é recusado sem resolver nenhum
+    ResultadoLote resultado;
+    CU_ASSERT_EQUAL(resolverLote(LISTA_LOTE_TEST, SAIDA_LOTE_TEST, 2, &resultado), -1);
+    CU_ASSERT_EQUAL(resultado.resolvidos, 0);
+    CU_ASSERT_EQUAL(resultado.erros, 1);
+    file = fopen(SAIDA_LOTE_TEST "/" TABULEIRO_TEST, "r");
+    CU_ASSERT_PTR_NULL(file);
+    if (file) fclose(file);
+    
+    remove(PASTA_LOTE_TEST "/" TABULEIRO_TEST);
+    rmdir(PASTA_LOTE_TEST);
+    rmdir(SAIDA_LOTE_TEST);
+    remove(LISTA_LOTE_TEST);
+    limpar_arquivo_teste();
+}
+
 // ===== Teste para verificar o comando de ajuda (a) com jogo inválido =====
 void teste_comando_ajuda_jogo_invalido() {
     // Tentando ajudar em um jogo nulo
@@ -833,6 +2184,44 @@ void teste_gravar_jogo_invalido() {
     limpar_arquivo_teste();
 }
 
+void teste_gravar_historico_com_grupos() {
+    criar_arquivo_teste();
+    Jogo *jogo = carregarJogo(TABULEIRO_TEST);
+    
+    pintarBranco(jogo, "a1");
+    iniciarAgrupamentoMovimentos(jogo);
+    pintarBranco(jogo, "b1");
+    riscar(jogo, "c1");
+    finalizarAgrupamentoMovimentos(jogo);
+    pintarBranco(jogo, "e1");
+    CU_ASSERT_EQUAL(gravarJogo(jogo, "jogo_salvo.txt"), 0);
+    
+    // O histórico carregado mantém a ordem e as marcas de grupo
+    Jogo *jogoCarregado = carregarJogo("jogo_salvo.txt");
+    CU_ASSERT_PTR_NOT_NULL(jogoCarregado);
+    if (jogoCarregado) {
+        CU_ASSERT_EQUAL(numeroMovimentos(jogoCarregado), 4);
+        for (int k = 0; k < 4 && k < numeroMovimentos(jogoCarregado); k++) {
+            Movimento *gravado = &jogo->historico.movimentos[k];
+            Movimento *lido = &jogoCarregado->historico.movimentos[k];
+            CU_ASSERT_EQUAL(lido->linha, gravado->linha);
+            CU_ASSERT_EQUAL(lido->coluna, gravado->coluna);
+            CU_ASSERT_EQUAL(lido->estadoAnterior, gravado->estadoAnterior);
+            CU_ASSERT_EQUAL(lido->grupo, gravado->grupo);
+        }
+        
+        desfazerMovimento(jogoCarregado);
+        desfazerMovimento(jogoCarregado);
+        CU_ASSERT_EQUAL(numeroMovimentos(jogoCarregado), 1);
+        CU_ASSERT_STRING_EQUAL(jogoCarregado->tabuleiro[0], "Ecadc");
+        freeJogo(jogoCarregado);
+    }
+    remove("jogo_salvo.txt");
+    
+    freeJogo(jogo);
+    limpar_arquivo_teste();
+}
+
 // ===== Configuração da suíte de testes =====
 
 int inicializar() {
@@ -861,6 +2250,7 @@ int main() {
     // Adiciona os testes à suíte
     // Testes para carregamento de jogo
     CU_add_test(pSuite, "teste_carregar_jogo_valido", teste_carregar_jogo_valido);
+    CU_add_test(pSuite, "teste_carregar_jogo_marca_antiga", teste_carregar_jogo_marca_antiga);
     CU_add_test(pSuite, "teste_carregar_jogo_arquivo_inexistente", teste_carregar_jogo_arquivo_inexistente);
     
     // Testes para pintar e riscar
@@ -869,10 +2259,17 @@ int main() {
     CU_add_test(pSuite, "teste_riscar_valido", teste_riscar_valido);
     CU_add_test(pSuite, "teste_riscar_invalido", teste_riscar_invalido);
     
+    // Testes para o tabuleiro contíguo
+    CU_add_test(pSuite, "teste_copiar_jogo_tabuleiro_contiguo", teste_copiar_jogo_tabuleiro_contiguo);
+    
     // Testes para registo e desfazer movimentos
     CU_add_test(pSuite, "teste_registar_movimento", teste_registar_movimento);
     CU_add_test(pSuite, "teste_desfazer_movimento", teste_desfazer_movimento);
     CU_add_test(pSuite, "teste_desfazer_movimento_sem_historico", teste_desfazer_movimento_sem_historico);
+    CU_add_test(pSuite, "teste_desfazer_grupo_movimentos", teste_desfazer_grupo_movimentos);
+    CU_add_test(pSuite, "teste_refazer_movimentos", teste_refazer_movimentos);
+    CU_add_test(pSuite, "teste_ir_para_movimento_com_pontos", teste_ir_para_movimento_com_pontos);
+    CU_add_test(pSuite, "teste_ir_para_movimento_depois_de_resolver", teste_ir_para_movimento_depois_de_resolver);
     CU_add_test(pSuite, "teste_desfazer_multiplos_movimentos", teste_desfazer_multiplos_movimentos);
     
     // Testes para verificação de restrições
@@ -886,6 +2283,9 @@ int main() {
     CU_add_test(pSuite, "teste_verificar_restricao_vizinhos_riscados_dois_riscados",  teste_verificar_restricao_vizinhos_riscados_dois_riscados);
     CU_add_test(pSuite, "teste_verificar_restricao_vizinhos_riscados_tres_riscados",  teste_verificar_restricao_vizinhos_riscados_tres_riscados);
     
+    // Testes para as máscaras do tabuleiro
+    CU_add_test(pSuite, "teste_mascaras_sincronizadas", teste_mascaras_sincronizadas);
+    
     // Testes para verificação de conectividade
     CU_add_test(pSuite, "teste_verificar_conectividade_sem_brancas", teste_verificar_conectividade_sem_brancas);
     CU_add_test(pSuite, "teste_verificar_conectividade_com_brancas_conectadas", teste_verificar_conectividade_com_brancas_conectadas);
@@ -893,15 +2293,70 @@ int main() {
     CU_add_test(pSuite, "teste_verificar_conectividade_com_brancas_desconectadas", teste_verificar_conectividade_com_brancas_desconectadas);
     CU_add_test(pSuite, "teste_verificar_conectividade_com_brancas_desconectadas_diagonal", teste_verificar_conectividade_com_brancas_desconectadas_diagonal);
     CU_add_test(pSuite, "teste_verificar_conectividade_com_brancas_desconectadas_e_conectadas", teste_verificar_conectividade_com_brancas_desconectadas_e_conectadas);
+    CU_add_test(pSuite, "teste_uniao_riscadas_separacao", teste_uniao_riscadas_separacao);
+    CU_add_test(pSuite, "teste_conectividade_reutiliza_area_trabalho", teste_conectividade_reutiliza_area_trabalho);
 
     //Testes para o comando ajuda (a)
     CU_add_test(pSuite, "teste_comando_ajuda", teste_comando_ajuda);
+    CU_add_test(pSuite, "teste_ajuda_pontos_articulacao", teste_ajuda_pontos_articulacao);
+    CU_add_test(pSuite, "teste_ajudar_colunas_largas", teste_ajudar_colunas_largas);
     CU_add_test(pSuite, "teste_modo_ajuda_automatica", teste_modo_ajuda_automatica);
+    CU_add_test(pSuite, "teste_ajuda_automatica_igual_ajudar", teste_ajuda_automatica_igual_ajudar);
+    CU_add_test(pSuite, "teste_ajuda_automatica_rondas_e_desfazer", teste_ajuda_automatica_rondas_e_desfazer);
+    CU_add_test(pSuite, "teste_regras_sanduiche_e_par", teste_regras_sanduiche_e_par);
+    CU_add_test(pSuite, "teste_regras_canto_e_letra_unica", teste_regras_canto_e_letra_unica);
+    CU_add_test(pSuite, "teste_sondagem_ajuda_automatica", teste_sondagem_ajuda_automatica);
+    CU_add_test(pSuite, "teste_sondagem_orcamento", teste_sondagem_orcamento);
     CU_add_test(pSuite, "teste_resolver_jogo", teste_resolver_jogo);
     CU_add_test(pSuite, "teste_comando_ajuda_jogo_invalido", teste_comando_ajuda_jogo_invalido);
     CU_add_test(pSuite, "teste_resolver_jogo_invalido", teste_resolver_jogo_invalido);
     CU_add_test(pSuite, "teste_interacao_comandos_a_A_R", teste_interacao_comandos_a_A_R);
 
+    // Testes para o resolvedor com propagação
+    CU_add_test(pSuite, "teste_resolver_com_propagacao", teste_resolver_com_propagacao);
+    CU_add_test(pSuite, "teste_propagar_deducoes_contradicao", teste_propagar_deducoes_contradicao);
+    CU_add_test(pSuite, "teste_resolver_sem_solucao_preserva_tabuleiro", teste_resolver_sem_solucao_preserva_tabuleiro);
+    CU_add_test(pSuite, "teste_rasto_volta_ao_nivel", teste_rasto_volta_ao_nivel);
+    CU_add_test(pSuite, "teste_resolver_jogo_regista_movimentos", teste_resolver_jogo_regista_movimentos);
+    CU_add_test(pSuite, "teste_repor_tabuleiro_inicial", teste_repor_tabuleiro_inicial);
+    CU_add_test(pSuite, "teste_tabuleiro_inicial_de_jogo_gravado", teste_tabuleiro_inicial_de_jogo_gravado);
+    CU_add_test(pSuite, "teste_resolver_paralelo_igual_sequencial", teste_resolver_paralelo_igual_sequencial);
+    CU_add_test(pSuite, "teste_resolver_paralelo_sem_solucao", teste_resolver_paralelo_sem_solucao);
+    CU_add_test(pSuite, "teste_processar_comando_resolver_threads", teste_processar_comando_resolver_threads);
+    CU_add_test(pSuite, "teste_heuristicas_ramificacao", teste_heuristicas_ramificacao);
+    CU_add_test(pSuite, "teste_processar_comando_heuristica", teste_processar_comando_heuristica);
+    CU_add_test(pSuite, "teste_aprendizagem_nogoods", teste_aprendizagem_nogoods);
+    CU_add_test(pSuite, "teste_tabela_transposicao", teste_tabela_transposicao);
+    
+    // Testes para a validação estruturada
+    CU_add_test(pSuite, "teste_validar_tabuleiro_estruturado", teste_validar_tabuleiro_estruturado);
+    CU_add_test(pSuite, "teste_validar_tabuleiro_so_contagens", teste_validar_tabuleiro_so_contagens);
+    
+    // Testes para os contadores do tabuleiro
+    CU_add_test(pSuite, "teste_contadores_incrementais", teste_contadores_incrementais);
+    CU_add_test(pSuite, "teste_hash_zobrist", teste_hash_zobrist);
+    CU_add_test(pSuite, "teste_arena_marcas", teste_arena_marcas);
+    CU_add_test(pSuite, "teste_slab_reaproveita", teste_slab_reaproveita);
+    CU_add_test(pSuite, "teste_arena_jogo_reaproveitada", teste_arena_jogo_reaproveitada);
+    CU_add_test(pSuite, "teste_vitoria_pelos_contadores", teste_vitoria_pelos_contadores);
+    
+    // Testes para a validação incremental
+    CU_add_test(pSuite, "teste_validacao_incremental_igual_completa", teste_validacao_incremental_igual_completa);
+    CU_add_test(pSuite, "teste_validacao_incremental_vizinhanca", teste_validacao_incremental_vizinhanca);
+    
+    // Testes para contagem de soluções e geração
+    CU_add_test(pSuite, "teste_contar_solucoes", teste_contar_solucoes);
+    CU_add_test(pSuite, "teste_contar_solucoes_com_nogoods", teste_contar_solucoes_com_nogoods);
+    CU_add_test(pSuite, "teste_processar_comando_contar", teste_processar_comando_contar);
+    CU_add_test(pSuite, "teste_gerar_jogo_unico", teste_gerar_jogo_unico);
+    CU_add_test(pSuite, "teste_gerar_jogo_grande", teste_gerar_jogo_grande);
+    
+    // Testes para a resolução em lote
+    CU_add_test(pSuite, "teste_resolver_lote_lista", teste_resolver_lote_lista);
+    CU_add_test(pSuite, "teste_resolver_lote_ficheiro_invalido", teste_resolver_lote_ficheiro_invalido);
+    CU_add_test(pSuite, "teste_resolver_lote_ignora_movimentos", teste_resolver_lote_ignora_movimentos);
+    CU_add_test(pSuite, "teste_resolver_lote_nomes_repetidos", teste_resolver_lote_nomes_repetidos);
+
 
     // Testes para processamento de comandos
     CU_add_test(pSuite, "teste_processar_comando_carregar", teste_processar_comando_carregar);
@@ -919,6 +2374,7 @@ int main() {
     // Testes para gravação de jogo
     CU_add_test(pSuite, "teste_gravar_jogo_valido", teste_gravar_jogo_valido);
     CU_add_test(pSuite, "teste_gravar_jogo_invalido", teste_gravar_jogo_invalido);
+    CU_add_test(pSuite, "teste_gravar_historico_com_grupos", teste_gravar_historico_com_grupos);
 
     // Executa todos os testes usando a interface básica do CUnit
     CU_basic_set_mode(CU_BRM_VERBOSE);